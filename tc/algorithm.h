@@ -47,6 +47,8 @@
 #include "cont_reserve.h"
 #include "size_linear.h"
 #include "filter_adaptor.h"
+#include "flat_hash.h"
+#include "radix_sort.h"
 
 #include <boost/preprocessor/repetition/enum.hpp>
 #include <boost/utility.hpp>
@@ -59,9 +61,13 @@
 #include <boost/intrusive/set.hpp>
 
 #include <type_traits>
+#include <cstdint>
+#include <limits>
+#include <optional>
 #include <set>
 #include <map>
 #include <utility>
+#include <initializer_list>
 #include <algorithm>
 
 namespace tc {
@@ -157,19 +163,208 @@ namespace tc {
 	}
 	template<typename Rng, typename Pred, std::enable_if_t<!has_mem_fn_sort< Rng >::value>* = nullptr>
 	void sort_inplace(Rng& rng, Pred&& pred) noexcept {
-		std::sort( tc::begin(rng), tc::end(rng), std::forward<Pred>(pred) );
+		if constexpr( tc::is_radix_sortable<Rng, Pred>::value ) {
+			tc::radix_sort_inplace( rng, pred );
+		} else {
+			std::sort( tc::begin(rng), tc::end(rng), std::forward<Pred>(pred) );
+		}
 	}
 	template<typename Rng>
 	void sort_inplace(Rng& rng) noexcept {
 		tc::sort_inplace( rng, tc::fn_less() );
 	}
 
+	/////////////////////////////////////////////////////
+	// selection
+
+	// Puts the element which would be at position n after sorting at position n, smaller ones before and greater ones after it. O(size).
+	template<typename Rng, typename Less=tc::fn_less>
+	void nth_element_inplace(Rng&& rng, typename boost::range_size<std::remove_reference_t<Rng>>::type n, Less&& less=Less()) noexcept {
+		_ASSERT( n<tc::size_raw(rng) );
+		std::nth_element( tc::begin(rng), tc::begin_next(rng, n), tc::end(rng), std::forward<Less>(less) );
+	}
+
+	// Sorts the n smallest elements into the front of rng, leaving the rest in unspecified order. O(size + n log n).
+	// If n is at least the size of rng, sorts all of rng.
+	template<typename Rng, typename Less=tc::fn_less>
+	void partial_sort_inplace(Rng&& rng, typename boost::range_size<std::remove_reference_t<Rng>>::type n, Less less=Less()) noexcept {
+		auto const itMiddle=tc::begin_next(rng, tc::min(n, tc::size_raw(rng)));
+		if( itMiddle!=tc::end(rng) ) {
+			std::nth_element( tc::begin(rng), itMiddle, tc::end(rng), std::ref(less) );
+		}
+		auto rngFront=tc::take(rng, itMiddle);
+		tc::sort_inplace( rngFront, tc_move(less) );
+	}
+
+	namespace quantiles_detail {
+		// Puts each of the strictly increasing positions [itnBegin, itnEnd) into place. [itBegin, itEnd) starts at position nOffset.
+		template<typename It, typename Itn, typename Less>
+		void multi_select(It itBegin, It const itEnd, std::size_t nOffset, Itn itnBegin, Itn const itnEnd, Less& less) noexcept {
+			while( itnBegin!=itnEnd ) {
+				auto const itnMiddle=itnBegin+(itnEnd-itnBegin)/2;
+				auto const itNth=itBegin+(*itnMiddle-nOffset);
+				std::nth_element( itBegin, itNth, itEnd, std::ref(less) );
+				multi_select( itBegin, itNth, nOffset, itnBegin, itnMiddle, less );
+				itBegin=std::next(itNth);
+				nOffset=*itnMiddle+1;
+				itnBegin=std::next(itnMiddle);
+			}
+		}
+	}
+
+	// Elements at the quantiles q in [0, 1] of rngq, i.e., at position floor(q*(size-1)) after sorting, in the order of rngq.
+	// Selects on a copy of rng in O(size * log(size(rngq))).
+	template<typename Rng, typename RngQ, typename Less=tc::fn_less>
+	[[nodiscard]] auto quantiles(Rng&& rng, RngQ const& rngq, Less less=Less()) noexcept {
+		auto vec=tc::make_vector(std::forward<Rng>(rng));
+		_ASSERT( !tc::empty(vec) );
+		auto const fnposition=[&](double q) noexcept {
+			_ASSERT( 0<=q && q<=1 );
+			return static_cast<std::size_t>(q*(tc::size_raw(vec)-1));
+		};
+		auto vecnPosition=tc::make_vector(tc::transform(rngq, fnposition));
+		tc::sort_inplace(vecnPosition);
+		tc::take_inplace(vecnPosition, std::unique(tc::begin(vecnPosition), tc::end(vecnPosition)));
+		quantiles_detail::multi_select( tc::begin(vec), tc::end(vec), 0, tc::begin(vecnPosition), tc::end(vecnPosition), less );
+		return tc::make_vector(tc::transform(rngq, [&](double q) noexcept -> decltype(auto) {
+			return tc::as_const(vec[fnposition(q)]);
+		}));
+	}
+
+	template<typename Rng, typename Less=tc::fn_less>
+	[[nodiscard]] auto quantiles(Rng&& rng, std::initializer_list<double> ilq, Less less=Less()) noexcept {
+		return tc::quantiles<Rng, std::initializer_list<double>, Less>(std::forward<Rng>(rng), ilq, tc_move(less));
+	}
+
+	/////////////////////////////////////////////////////
+	// sort by key
+
+	DEFINE_TAG_TYPE(sort_by_key_tag)
+
+	namespace sort_by_key_detail {
+		// Order of the elements fnelem(0), ..., fnelem(n-1) by key proj(elem), evaluating proj exactly once per element.
+		// With bStable, lessorcomp is a three-way comparison and equal keys keep their order.
+		template<bool bStable, typename FnElem, typename Proj, typename LessOrComp>
+		tc::vector<std::size_t> sorted_permutation(std::size_t const n, FnElem fnelem, Proj& proj, LessOrComp& lessorcomp) noexcept {
+			using key_type = tc::decay_t<decltype(tc::invoke(proj, fnelem(std::size_t(0))))>;
+			tc::vector<key_type> veckey;
+			veckey.reserve(n);
+			for( std::size_t i=0; i<n; ++i ) {
+				tc::cont_emplace_back(veckey, tc::invoke(proj, fnelem(i)));
+			}
+			if constexpr( radix_sort_detail::is_radix_sortable_elem<LessOrComp, key_type const&>::value ) {
+				// radix sort is stable, which also satisfies bStable
+				if( radix_sort_detail::c_nRadixSortMinSize<=n ) {
+					return radix_sort_detail::sorted_permutation(n, lessorcomp, [&](std::size_t i) noexcept -> key_type const& {
+						return veckey[i];
+					});
+				}
+			}
+			auto veci=tc::make_vector(tc::iota(std::size_t(0), n));
+			if constexpr( bStable ) {
+				std::stable_sort(tc::begin(veci), tc::end(veci), [&](std::size_t iLhs, std::size_t iRhs) noexcept -> bool {
+					STATICASSERTSAME(decltype(lessorcomp(veckey[iLhs], veckey[iRhs])), tc::order);
+					return tc::order::less==lessorcomp(veckey[iLhs], veckey[iRhs]);
+				});
+			} else {
+				std::sort(tc::begin(veci), tc::end(veci), [&](std::size_t iLhs, std::size_t iRhs) noexcept -> bool {
+					return lessorcomp(veckey[iLhs], veckey[iRhs]);
+				});
+			}
+			return veci;
+		}
+
+		template<bool bStable, typename Rng, typename Proj, typename LessOrComp>
+		void sort_inplace_by_key(Rng& rng, Proj proj, LessOrComp lessorcomp) noexcept {
+			static_assert(tc::is_random_access_range<Rng>::value);
+			auto const itBegin=tc::begin(rng);
+			radix_sort_detail::move_into_order(itBegin, sort_by_key_detail::sorted_permutation<bStable>(tc::size_raw(rng), [&](std::size_t i) noexcept -> decltype(auto) {
+				return tc::as_const(itBegin[i]);
+			}, proj, lessorcomp));
+		}
+	}
+
+	// Like tc::sort_inplace(rng, tc::projected(less, proj)), but evaluates proj exactly once per element.
+	template<typename Rng, typename Proj, typename Less=tc::fn_less>
+	void sort_inplace_by_key(Rng&& rng, Proj proj, Less less=Less()) noexcept {
+		sort_by_key_detail::sort_inplace_by_key<false/*bStable*/>(rng, tc_move(proj), tc_move(less));
+	}
+
+	template<typename Rng, typename Proj, typename Comp=tc::fn_compare>
+	void stable_sort_inplace_by_key(Rng&& rng, Proj proj, Comp comp=Comp()) noexcept {
+		sort_by_key_detail::sort_inplace_by_key<true/*bStable*/>(rng, tc_move(proj), tc_move(comp));
+	}
+
+	namespace sorted_index_adaptor_detail {
+		// Positions into contiguous ranges are stored as 32 bit integers, which are half the size of iterators and cheap to move while sorting.
+		// Only contiguous ranges turn a position back into an index in O(1); e.g., concat or join advance in O(number of components) or O(log n).
+		// Ranges with 4G elements or more fall back to std::size_t positions.
+		template<typename Rng>
+		using compact_index = tc::has_ptr_begin<std::remove_reference_t<Rng>&>;
+
+		template<typename Rng>
+		using stored_index_t = std::conditional_t<compact_index<Rng>::value, std::uint32_t, tc::index_t<std::remove_reference_t<Rng>>>;
+
+		constexpr std::size_t c_nMinAverageRunLength=8;
+
+		// Splits [itBegin, itEnd) into maximal ascending and strictly descending runs.
+		// Returns nothing, leaving the range unchanged, if the runs are shorter than c_nMinAverageRunLength on average.
+		// Otherwise reverses the descending runs and returns the run boundaries including itBegin and itEnd.
+		template<typename It, typename Less>
+		std::optional<tc::vector<It>> ascending_runs(It const itBegin, It const itEnd, Less& less) noexcept {
+			std::size_t const nMaxRuns=tc::max(static_cast<std::size_t>(itEnd-itBegin)/c_nMinAverageRunLength, std::size_t(1));
+			tc::vector<It> vecit;
+			tc::vector<std::size_t> veciDescending;
+			tc::cont_emplace_back(vecit, itBegin);
+			for( It it=itBegin; it!=itEnd; ) {
+				if( nMaxRuns<tc::size_raw(vecit) ) return std::nullopt;
+				It itRunEnd=std::next(it);
+				if( itRunEnd!=itEnd ) {
+					// each adjacent pair is compared once
+					if( less(*itRunEnd, *it) ) {
+						tc::cont_emplace_back(veciDescending, tc::size_raw(vecit)-1);
+						do {
+							++itRunEnd;
+						} while( itRunEnd!=itEnd && less(*itRunEnd, *std::prev(itRunEnd)) );
+					} else {
+						do {
+							++itRunEnd;
+						} while( itRunEnd!=itEnd && !less(*itRunEnd, *std::prev(itRunEnd)) );
+					}
+				}
+				it=itRunEnd;
+				tc::cont_emplace_back(vecit, it);
+			}
+			for( std::size_t const i : veciDescending ) {
+				std::reverse(vecit[i], vecit[i+1]);
+			}
+			return vecit;
+		}
+
+		// Merges adjacent runs pairwise until one sorted run remains, in O(n log(number of runs)).
+		template<typename It, typename Less>
+		void merge_runs(tc::vector<It>& vecitRun, Less& less) noexcept {
+			while( 2<tc::size_raw(vecitRun) ) {
+				std::size_t iOut=0;
+				std::size_t i=0;
+				for( ; i+2<tc::size_raw(vecitRun); i+=2 ) {
+					std::inplace_merge(vecitRun[i], vecitRun[i+1], vecitRun[i+2], std::ref(less));
+					vecitRun[iOut++]=vecitRun[i];
+				}
+				for( ; i<tc::size_raw(vecitRun); ++i ) {
+					vecitRun[iOut++]=vecitRun[i];
+				}
+				vecitRun.resize(iOut);
+			}
+		}
+	}
+
 	namespace no_adl {
 		template<typename Rng, bool bStable>
 		struct [[nodiscard]] sorted_index_adaptor final:
 			tc::range_iterator_generator_from_index<
 				sorted_index_adaptor<Rng, bStable>,
-				typename boost::range_iterator<tc::vector<tc::index_t<std::remove_reference_t<Rng>>> const>::type
+				std::size_t // position in sorted order
 			>,
 			tc::nonmovable // disable copy ctor and default move ctor
 		{
@@ -178,43 +373,113 @@ namespace tc {
 		private:
 			using this_type = sorted_index_adaptor;
 
+			using stored_index = sorted_index_adaptor_detail::stored_index_t<Rng>;
+			static constexpr bool c_bCompactIndex = sorted_index_adaptor_detail::compact_index<Rng>::value;
+
 			tc::reference_or_value<Rng> m_baserng;
-			tc::vector<tc::index_t<std::remove_reference_t<Rng>>> m_vecidx;
+			tc::vector<stored_index> m_vecidx;
+			tc::vector<std::size_t> m_vecnWide; // instead of m_vecidx for compact indices into ranges too large for std::uint32_t
 
 		public:
-			using difference_type = typename decltype(m_vecidx)::difference_type;
+			using difference_type = std::ptrdiff_t;
+
+		private:
+			void append_indices() & noexcept {
+				if constexpr( c_bCompactIndex ) {
+					auto const n=tc::size_raw(*m_baserng);
+					if( n<=std::numeric_limits<std::uint32_t>::max() ) {
+						m_vecidx=tc::make_vector(tc::iota(std::uint32_t(0), static_cast<std::uint32_t>(n)));
+					} else {
+						m_vecnWide=tc::make_vector(tc::iota(std::size_t(0), n));
+					}
+				} else {
+					if constexpr (tc::has_size<Rng>::value) {
+						tc::cont_reserve(m_vecidx, tc::size(*m_baserng));
+					}
+					for(auto idx=tc::begin_index(m_baserng); !tc::at_end_index(*m_baserng, idx); tc::increment_index(*m_baserng, idx)) {
+						tc::cont_emplace_back(m_vecidx, idx);
+					}
+				}
+			}
+
+			// calls func with whichever of m_vecidx and m_vecnWide is in use
+			template<typename Func>
+			void with_stored_indices(Func func) & noexcept {
+				if constexpr( c_bCompactIndex ) {
+					if( !tc::empty(m_vecnWide) ) {
+						func(m_vecnWide);
+						return;
+					}
+				}
+				func(m_vecidx);
+			}
 
+			template<typename StoredIndex>
+			auto base_index(StoredIndex const& idx) const& noexcept {
+				if constexpr( c_bCompactIndex ) {
+					auto idxBase=tc::begin_index(m_baserng);
+					tc::advance_index(*m_baserng, idxBase, static_cast<typename boost::range_difference<std::remove_reference_t<Rng>>::type>(idx));
+					return idxBase;
+				} else {
+					return idx;
+				}
+			}
+
+			template<typename StoredIndex>
+			decltype(auto) dereference_stored(StoredIndex const& idx) const& noexcept {
+				return tc::dereference_index(tc::as_const(*m_baserng), base_index(idx));
+			}
+
+			auto base_index_at(std::size_t const n) const& noexcept {
+				if constexpr( c_bCompactIndex ) {
+					if( !tc::empty(m_vecnWide) ) return base_index(m_vecnWide[n]);
+				}
+				return base_index(m_vecidx[n]);
+			}
+
+		public:
 			template<typename LessOrComp>
 			explicit sorted_index_adaptor(Rng&& rng, LessOrComp lessorcomp) noexcept
 				: m_baserng(tc::aggregate_tag, std::forward<Rng>(rng))
 			{
-				if constexpr (tc::has_size<Rng>::value) {
-					tc::cont_reserve(m_vecidx, tc::size(*m_baserng));
-				}
-				for(auto idx=tc::begin_index(m_baserng); idx!=tc::end_index(m_baserng); tc::increment_index(*m_baserng, idx)) {
-					tc::cont_emplace_back(m_vecidx, idx);
-				}
-				tc::sort_inplace(
-					m_vecidx,
-					[&](auto const& idxLhs, auto const& idxRhs ) noexcept -> bool {
-						auto_cref(lhs, tc::dereference_index(*m_baserng, idxLhs));
-						auto_cref(rhs, tc::dereference_index(*m_baserng, idxRhs));
-						if constexpr (bStable) {
-							static_assert(tc::is_random_access_range<Rng>::value);
-							STATICASSERTSAME(decltype(lessorcomp(lhs, rhs)), tc::order);
-							switch_no_default(lessorcomp(lhs, rhs)) {
-								case tc::order::equal:
-									return 0<tc::distance_to_index(*m_baserng, idxLhs, idxRhs);
-								case tc::order::less:
-									return true;
-								case tc::order::greater:
-									return false;
-							}
-						} else {
-							return lessorcomp(lhs, rhs);
+				append_indices();
+				with_stored_indices([&](auto& vecidx) noexcept {
+					sort_stored_indices(vecidx, lessorcomp);
+				});
+			}
+
+			// ordered by proj(element), evaluating proj exactly once per element
+			template<typename Proj, typename LessOrComp>
+			explicit sorted_index_adaptor(sort_by_key_tag_t, Rng&& rng, Proj proj, LessOrComp lessorcomp) noexcept
+				: m_baserng(tc::aggregate_tag, std::forward<Rng>(rng))
+			{
+				append_indices();
+				with_stored_indices([&](auto& vecidx) noexcept {
+					auto const veci=sort_by_key_detail::sorted_permutation<bStable>(tc::size_raw(vecidx), [&](std::size_t i) noexcept -> decltype(auto) {
+						return dereference_stored(vecidx[i]);
+					}, proj, lessorcomp);
+					vecidx=tc::make_vector(tc::transform(veci, [&](std::size_t i) noexcept { return vecidx[i]; }));
+				});
+			}
+
+			// only the nFirst smallest elements, in O(size + nFirst log nFirst)
+			template<typename Less>
+			explicit sorted_index_adaptor(Rng&& rng, Less less, std::size_t nFirst) noexcept
+				: m_baserng(tc::aggregate_tag, std::forward<Rng>(rng))
+			{
+				static_assert(!bStable);
+				append_indices();
+				with_stored_indices([&](auto& vecidx) noexcept {
+					auto const itFirstEnd=tc::begin_next(vecidx, tc::min(nFirst, tc::size_raw(vecidx)));
+					tc::partial_sort_inplace(
+						vecidx,
+						tc::distance(tc::begin(vecidx), itFirstEnd),
+						[&](auto const& idxLhs, auto const& idxRhs ) noexcept -> bool {
+							return less(dereference_stored(idxLhs), dereference_stored(idxRhs));
 						}
-					}
-				);
+					);
+					tc::take_inplace(vecidx, itFirstEnd);
+				});
 			}
 
 			template<ENABLE_SFINAE, std::enable_if_t<
@@ -224,23 +489,72 @@ namespace tc {
 			explicit sorted_index_adaptor(sorted_index_adaptor&& rng) noexcept
 				: m_baserng(tc_move(rng).m_baserng)
 				, m_vecidx(tc_move(rng).m_vecidx)
+				, m_vecnWide(tc_move(rng).m_vecnWide)
 			{
 			}
+
 		private:
+			template<typename StoredIndex, typename LessOrComp>
+			void sort_stored_indices(tc::vector<StoredIndex>& vecidx, LessOrComp& lessorcomp) & noexcept {
+				// With bStable, ties are broken by position, which makes equal elements neither ascending nor strictly descending runs.
+				auto lessIndex=[&](StoredIndex const& idxLhs, StoredIndex const& idxRhs) noexcept -> bool {
+					auto_cref(lhs, dereference_stored(idxLhs));
+					auto_cref(rhs, dereference_stored(idxRhs));
+					if constexpr (bStable) {
+						static_assert(tc::is_random_access_range<Rng>::value);
+						STATICASSERTSAME(decltype(lessorcomp(lhs, rhs)), tc::order);
+						switch_no_default(lessorcomp(lhs, rhs)) {
+							case tc::order::equal:
+								if constexpr( c_bCompactIndex ) {
+									return idxLhs<idxRhs;
+								} else {
+									return 0<tc::distance_to_index(*m_baserng, idxLhs, idxRhs);
+								}
+							case tc::order::less:
+								return true;
+							case tc::order::greater:
+								return false;
+						}
+					} else {
+						return lessorcomp(lhs, rhs);
+					}
+				};
+
+				// Input is often (nearly) sorted. Reversing strictly descending runs keeps equal elements in order.
+				auto ovecitRun=sorted_index_adaptor_detail::ascending_runs(tc::begin(vecidx), tc::end(vecidx), lessIndex);
+				if( ovecitRun && tc::size_raw(*ovecitRun)<=2 ) return;
+
+				if constexpr( radix_sort_detail::is_radix_sortable_elem<LessOrComp, tc::range_reference_t<Rng const>>::value ) {
+					// radix sort is stable, which also satisfies bStable
+					if( !ovecitRun && radix_sort_detail::c_nRadixSortMinSize<=tc::size(vecidx) ) {
+						auto const veci=radix_sort_detail::sorted_permutation(tc::size_raw(vecidx), lessorcomp, [&](std::size_t i) noexcept -> decltype(auto) {
+							return dereference_stored(vecidx[i]);
+						});
+						vecidx=tc::make_vector(tc::transform(veci, [&](std::size_t i) noexcept { return vecidx[i]; }));
+						return;
+					}
+				}
+				if( ovecitRun ) {
+					sorted_index_adaptor_detail::merge_runs(*ovecitRun, lessIndex);
+				} else {
+					std::sort(tc::begin(vecidx), tc::end(vecidx), lessIndex);
+				}
+			}
+
 			STATIC_FINAL(begin_index)() const& noexcept -> index {
-				return tc::begin(m_vecidx);
+				return 0;
 			}
 
 			STATIC_FINAL(end_index)() const& noexcept -> index {
-				return tc::end(m_vecidx);
+				return tc::size_raw(m_vecidx)+tc::size_raw(m_vecnWide);
 			}
 
 			STATIC_FINAL(dereference_index)(index const& idx) const& return_decltype_MAYTHROW(
-				tc::dereference_index(*m_baserng, *idx)
+				tc::dereference_index(*m_baserng, base_index_at(idx))
 			)
 
 			STATIC_FINAL(dereference_index)(index const& idx) & return_decltype_MAYTHROW(
-				tc::dereference_index(*m_baserng, *idx)
+				tc::dereference_index(*m_baserng, base_index_at(idx))
 			)
 
 			STATIC_FINAL(equal_index)(index const& idxLhs, index const& idxRhs) const& noexcept -> bool {
@@ -260,11 +574,11 @@ namespace tc {
 			}
 
 			STATIC_FINAL(distance_to_index)(index const& idxLhs, index const& idxRhs) const& noexcept -> difference_type {
-				return idxRhs-idxLhs;
+				return static_cast<difference_type>(idxRhs)-static_cast<difference_type>(idxLhs);
 			}
 		public:
 			auto element_base_index(index const& idx) const& noexcept {
-				return *idx;
+				return base_index_at(idx);
 			}
 			constexpr decltype(auto) base_range() & noexcept {
 				return *m_baserng;
@@ -304,6 +618,28 @@ namespace tc {
 		return tc::sort(std::forward<Rng>(rng), tc::fn_less());
 	}
 
+	// the n smallest elements in sorted order, like tc::take_first(tc::sort(rng, less), n), but without sorting the rest
+	template<typename Rng, typename Less>
+	[[nodiscard]] auto partial_sort(Rng&& rng, std::size_t n, Less&& less) noexcept {
+		return tc::sorted_index_adaptor<Rng, false/*bStable*/>(std::forward<Rng>(rng), std::forward<Less>(less), n);
+	}
+
+	template<typename Rng>
+	[[nodiscard]] auto partial_sort(Rng&& rng, std::size_t n) noexcept {
+		return tc::partial_sort(std::forward<Rng>(rng), n, tc::fn_less());
+	}
+
+	// Like tc::sort(rng, tc::projected(less, proj)), but evaluates proj exactly once per element.
+	template<typename Rng, typename Proj, typename Less=tc::fn_less>
+	[[nodiscard]] auto sort_by_key(Rng&& rng, Proj&& proj, Less&& less=Less()) noexcept {
+		return tc::sorted_index_adaptor<Rng, false/*bStable*/>(tc::sort_by_key_tag, std::forward<Rng>(rng), std::forward<Proj>(proj), std::forward<Less>(less));
+	}
+
+	template<typename Rng, typename Proj, typename Comp=tc::fn_compare>
+	[[nodiscard]] auto stable_sort_by_key(Rng&& rng, Proj&& proj, Comp&& comp=Comp()) noexcept {
+		return tc::sorted_index_adaptor<Rng, true/*bStable*/>(tc::sort_by_key_tag, std::forward<Rng>(rng), std::forward<Proj>(proj), std::forward<Comp>(comp));
+	}
+
 	template<typename Rng, typename Comp>
 	[[nodiscard]] auto stable_sort(Rng&& rng, Comp&& comp) noexcept {
 		return tc::sorted_index_adaptor<Rng, true/*bStable*/>(std::forward<Rng>(rng), std::forward<Comp>(comp));
@@ -383,6 +719,35 @@ namespace tc {
 		}
 	}
 
+	// Same contract as sort_accumulate_each_unique_range, but groups equal elements in expected O(n) by hashing instead of sorting.
+	// The first occurrence of each group is kept and the container order of the kept elements is preserved.
+	template< typename Rng, typename Hash, typename Equal, typename Accu >
+	void hash_accumulate_each_unique(Rng&& cont, Hash hash, Equal equal, Accu accu) noexcept {
+		tc::vector< typename boost::range_iterator<std::remove_reference_t<Rng>>::type > vecitFirst;
+		{
+			// index into vecitFirst, avoids copying the elements into the hash table
+			auto const fnhash=[&](std::size_t i) noexcept -> std::size_t {
+				return hash(tc::as_const(*vecitFirst[i]));
+			};
+			auto const fnequal=[&](std::size_t iLhs, std::size_t iRhs) noexcept -> bool {
+				return equal(tc::as_const(*vecitFirst[iLhs]), tc::as_const(*vecitFirst[iRhs]));
+			};
+			tc::flat_hash_set<std::size_t, decltype(fnhash), decltype(fnequal)> setiFirst(tc::size_raw(cont), fnhash, fnequal);
+			for( auto it=tc::begin(cont); it!=tc::end(cont); ++it ) {
+				tc::cont_emplace_back(vecitFirst, it);
+				if( auto const pairitb=setiFirst.insert(tc::size_raw(vecitFirst)-1); !pairitb.second ) {
+					vecitFirst.pop_back();
+					accu( *vecitFirst[*pairitb.first], *it );
+				}
+			}
+		}
+		{ range_filter< tc::decay_t<Rng> > rngfilter( cont );
+			tc::for_each(vecitFirst, [&](auto const& it) noexcept {
+				rngfilter.keep(it);
+			});
+		}
+	}
+
 	template< typename Cont, typename Equals = tc::fn_equal_to >
 	void front_unique_inplace(Cont & cont, Equals&& pred = Equals()) noexcept {
 		{
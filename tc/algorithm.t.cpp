@@ -12,7 +12,9 @@
 #include "concat_adaptor.h"
 #include "join_adaptor.h"
 #include "spirit_algorithm.h"
+#include "format.h"
 
+#include <deque>
 #include <random>
 
 namespace {
@@ -75,6 +77,30 @@ UNITTESTDEF( sort_accumulate_each_unique_range_2 ) {
 	}
 }
 
+UNITTESTDEF( hash_accumulate_each_unique ) {
+	struct SValAccu final {
+		SValAccu(int val, int accu) noexcept : m_val(val), m_accu(accu) {}
+		int m_val;
+		int m_accu;
+	};
+	tc::vector< SValAccu > vec;
+	for( int i=0; i < 100; ++i ) {
+		tc::cont_emplace_back( vec, (i*7)%10, i );
+	}
+	tc::hash_accumulate_each_unique(
+		vec,
+		[](SValAccu const& val) noexcept { return std::hash<int>()(val.m_val); },
+		[](SValAccu const& lhs, SValAccu const& rhs) noexcept { return lhs.m_val == rhs.m_val; },
+		[](SValAccu& lhs, SValAccu const& rhs) noexcept { lhs.m_accu+=rhs.m_accu; }
+	);
+	TEST_EQUAL( 10, vec.size() );
+	for( int i=0; i < 10; ++i ) {
+		// first occurrences in original order, with the sum of all indices with the same value
+		TEST_EQUAL( (i*7)%10, vec[i].m_val );
+		TEST_EQUAL( 10*i+450, vec[i].m_accu );
+	}
+}
+
 UNITTESTDEF(filter_no_self_assignment_of_rvalues) {
 	struct S {
 		S() {}
@@ -107,6 +133,151 @@ UNITTESTDEF( trim_leftright_if ) {
 	_ASSERTEQUAL(tc::size(tc::trim_right_if<tc::return_take>(rng, [] (int n) noexcept {return n==7;})), 3);
 }
 
+UNITTESTDEF( radix_sort ) {
+	std::mt19937 gen; // same sequence of numbers each time for reproducibility
+	std::uniform_int_distribution<std::int64_t> dist(std::numeric_limits<std::int64_t>::lowest(), std::numeric_limits<std::int64_t>::max());
+
+	auto vecn=tc::make_vector(tc::transform(tc::iota(0, 1000), [&](int) noexcept { return dist(gen); }));
+	auto vecnExpected=vecn;
+	std::sort(tc::begin(vecnExpected), tc::end(vecnExpected));
+	tc::sort_inplace(vecn);
+	TEST_RANGE_EQUAL(vecnExpected, vecn);
+
+	tc::sort_inplace(vecn, tc::fn_greater());
+	std::reverse(tc::begin(vecnExpected), tc::end(vecnExpected));
+	TEST_RANGE_EQUAL(vecnExpected, vecn);
+
+	// odd number of passes ends in the scratch buffer, non-contiguous ranges are sorted through a copy
+	std::uniform_int_distribution<std::uint32_t> distLow(0x7f000000, 0x7fffffff);
+	auto vecnLow=tc::make_vector(tc::transform(tc::iota(0, 1000), [&](int) noexcept { return distLow(gen); }));
+	std::deque<std::uint32_t> dequenLow(tc::begin(vecnLow), tc::end(vecnLow));
+	auto vecnLowExpected=vecnLow;
+	std::sort(tc::begin(vecnLowExpected), tc::end(vecnLowExpected));
+	tc::sort_inplace(vecnLow);
+	TEST_RANGE_EQUAL(vecnLowExpected, vecnLow);
+	tc::sort_inplace(dequenLow);
+	TEST_RANGE_EQUAL(vecnLowExpected, dequenLow);
+
+	auto vecf=tc::make_vector(tc::transform(vecn, [](std::int64_t n) noexcept { return static_cast<double>(n%1000)/7; }));
+	tc::cont_emplace_back(vecf, -0.0);
+	tc::cont_emplace_back(vecf, 0.0);
+	tc::sort_inplace(vecf);
+	_ASSERT( tc::is_sorted(vecf) );
+
+	auto vecstr=tc::make_vector(tc::transform(vecn, [](std::int64_t n) noexcept { return tc::make_str<char>(tc::as_dec(n%5000)); }));
+	tc::cont_emplace_back(vecstr, "");
+	tc::cont_emplace_back(vecstr, "\xff");
+	auto vecstrExpected=vecstr;
+	std::sort(tc::begin(vecstrExpected), tc::end(vecstrExpected));
+	tc::sort_inplace(vecstr);
+	TEST_RANGE_EQUAL(vecstrExpected, vecstr);
+
+	// projected keys, stable
+	auto vecpair=tc::make_vector(tc::transform(tc::iota(0, 1000), [](int i) noexcept { return std::make_pair(i%10, i); }));
+	auto const rngpairSorted=tc::stable_sort(vecpair, tc::projected(tc::fn_compare(), [](std::pair<int, int> const& pair) noexcept { return -pair.first; }));
+	_ASSERT( tc::is_strictly_sorted(tc::transform(rngpairSorted, [](std::pair<int, int> const& pair) noexcept { return -pair.first*1000+pair.second; })) );
+}
+
+UNITTESTDEF( partial_sort_nth_element_quantiles ) {
+	std::mt19937 gen; // same sequence of numbers each time for reproducibility
+	std::uniform_int_distribution<int> dist(0, 9999);
+	auto const vecn=tc::make_vector(tc::transform(tc::iota(0, 1001), [&](int) noexcept { return dist(gen); }));
+	auto vecnSorted=vecn;
+	std::sort(tc::begin(vecnSorted), tc::end(vecnSorted));
+
+	TEST_RANGE_EQUAL( tc::take_first(vecnSorted, 10), tc::partial_sort(vecn, 10) );
+	TEST_RANGE_EQUAL( vecnSorted, tc::partial_sort(vecn, 2000) );
+	_ASSERT( tc::empty(tc::partial_sort(vecn, 0)) );
+
+	auto vecnPartial=vecn;
+	tc::partial_sort_inplace(vecnPartial, 20, tc::fn_greater());
+	auto const rngnSortedDescending=tc::reverse(vecnSorted);
+	TEST_RANGE_EQUAL( tc::take_first(rngnSortedDescending, 20), tc::take_first(vecnPartial, 20) );
+	vecnPartial=vecn;
+	tc::partial_sort_inplace(vecnPartial, 2000); // n beyond the end sorts everything
+	TEST_RANGE_EQUAL( vecnSorted, vecnPartial );
+
+	auto vecnNth=vecn;
+	tc::nth_element_inplace(vecnNth, 500);
+	TEST_EQUAL( vecnSorted[500], vecnNth[500] );
+
+	auto const vecnQuantiles=tc::quantiles(vecn, {0.99, 0.0, 0.5, 1.0, 0.5});
+	tc::vector<int> const vecnQuantilesExpected{vecnSorted[990], vecnSorted[0], vecnSorted[500], vecnSorted[1000], vecnSorted[500]};
+	TEST_RANGE_EQUAL( vecnQuantilesExpected, vecnQuantiles );
+}
+
+UNITTESTDEF( sort_by_key ) {
+	std::mt19937 gen; // same sequence of numbers each time for reproducibility
+	std::uniform_int_distribution<int> dist(0, 99);
+	auto const vecn=tc::make_vector(tc::transform(tc::iota(0, 1000), [&](int) noexcept { return dist(gen); }));
+	auto const fnKey=[](int n) noexcept { return n/10; };
+
+	int nCalls=0;
+	auto const fnKeyCounted=[&](int n) noexcept { ++nCalls; return fnKey(n); };
+	auto vecnExpected=vecn;
+	std::stable_sort(tc::begin(vecnExpected), tc::end(vecnExpected), tc::projected(tc::fn_less(), fnKey));
+
+	TEST_RANGE_EQUAL( vecnExpected, tc::stable_sort_by_key(vecn, fnKeyCounted) );
+	TEST_EQUAL( nCalls, 1000 );
+
+	nCalls=0;
+	auto vecnInplace=vecn;
+	tc::stable_sort_inplace_by_key(tc::take_first(vecnInplace, 100), fnKeyCounted);
+	TEST_EQUAL( nCalls, 100 );
+	_ASSERT( tc::equal(tc::take_first(vecnInplace, 100), tc::stable_sort(tc::take_first(vecn, 100), tc::projected(tc::fn_compare(), fnKey))) );
+
+	nCalls=0;
+	vecnInplace=vecn;
+	tc::sort_inplace_by_key(vecnInplace, fnKeyCounted, tc::fn_greater());
+	TEST_EQUAL( nCalls, 1000 );
+	_ASSERT( tc::is_sorted(vecnInplace, tc::projected(tc::fn_greater(), fnKey)) );
+
+	tc::vector<std::string> const vecstr{"ccc", "a", "bb", "dddd"};
+	tc::vector<std::string> const vecstrExpected{"dddd", "ccc", "bb", "a"};
+	TEST_RANGE_EQUAL( vecstrExpected, tc::sort_by_key(vecstr, [](std::string const& str) noexcept { return str.size(); }, tc::fn_greater()) );
+}
+
+UNITTESTDEF( sort_presorted_runs ) {
+	auto const vecn=tc::make_vector(tc::iota(0, 1000));
+	int nCompare=0;
+	auto const lessCounted=[&](int lhs, int rhs) noexcept { ++nCompare; return lhs<rhs; };
+
+	TEST_RANGE_EQUAL( vecn, tc::sort(vecn, lessCounted) );
+	TEST_EQUAL( nCompare, 999 );
+	nCompare=0;
+	TEST_RANGE_EQUAL( vecn, tc::sort(tc::reverse(vecn), lessCounted) );
+	TEST_EQUAL( nCompare, 999 );
+
+	// a few elements out of place
+	auto vecnNearly=vecn;
+	std::swap(vecnNearly[10], vecnNearly[500]);
+	std::swap(vecnNearly[900], vecnNearly[901]);
+	TEST_RANGE_EQUAL( vecn, tc::sort(vecnNearly, lessCounted) );
+
+	// too many short descending runs are left alone and sorted as a whole
+	auto const vecnSwappedPairs=tc::make_vector(tc::transform(vecn, [](int n) noexcept { return n^1; }));
+	TEST_RANGE_EQUAL( vecn, tc::sort(vecnSwappedPairs) );
+
+	// not contiguous, so full indices are stored
+	TEST_RANGE_EQUAL( vecn, tc::sort(tc::concat(tc::take_first(vecnNearly, 500), tc::drop_first(vecnNearly, 500)), lessCounted) );
+
+	// strictly descending runs are reversed, but equal elements keep their order
+	tc::vector<std::pair<int, int>> vecpairnn;
+	for( int i=0; i<100; ++i ) {
+		tc::cont_emplace_back(vecpairnn, 99-i, 0);
+	}
+	for( int i=0; i<100; ++i ) {
+		tc::cont_emplace_back(vecpairnn, i, 1);
+	}
+	auto const rngSorted=tc::stable_sort(vecpairnn, tc::projected(tc::fn_compare(), [](auto const& pairnn) noexcept { return pairnn.first; }));
+	auto it=tc::begin(rngSorted);
+	for( int i=0; i<100; ++i ) {
+		_ASSERT( (std::pair<int, int>(i, 0))==*it ); ++it;
+		_ASSERT( (std::pair<int, int>(i, 1))==*it ); ++it;
+	}
+	_ASSERT( tc::end(rngSorted)==it );
+}
+
 UNITTESTDEF( is_sorted ) {
 	{
 		int a[]={0};
@@ -100,6 +100,53 @@ namespace tc {
 			)
 		};
 
+		// Assigns to elements which are already allocated, without capacity checks in release builds.
+		template< typename It >
+		struct [[nodiscard]] unchecked_writer /*final*/ {
+			using sink_value_type = tc::decay_t<decltype(*std::declval<It>())>;
+			constexpr explicit unchecked_writer(It& it, It const itEnd) noexcept: m_it(it), m_itEnd(itEnd) {}
+
+			template< typename T, std::enable_if_t<tc::econstructionIMPLICIT==tc::construction_restrictiveness<sink_value_type, T&&>::value>* = nullptr >
+			constexpr void operator()(T&& t) const& noexcept {
+				_ASSERTDEBUG( m_it!=m_itEnd ); // size() of the generator was too small
+				*m_it=std::forward<T>(t);
+				++m_it;
+			}
+
+			template< typename Rng >
+			auto chunk(Rng const& rng, std::enable_if_t<
+				!is_conv_enc_needed<sink_value_type, Rng>::value &&
+				!tc::is_concat_range<tc::remove_cvref_t<Rng>>::value &&
+				tc::is_random_access_range<Rng>::value &&
+				tc::econstructionIMPLICIT==tc::construction_restrictiveness<sink_value_type, tc::range_reference_t<Rng const>>::value
+			>* = nullptr) const& noexcept {
+				_ASSERTDEBUG( tc::end(rng)-tc::begin(rng)<=m_itEnd-m_it );
+				m_it=std::copy(tc::begin(rng), tc::end(rng), m_it);
+				return INTEGRAL_CONSTANT(tc::continue_)();
+			}
+
+			template< typename Rng >
+			auto chunk(Rng&& rng, std::enable_if_t<is_conv_enc_needed<sink_value_type, Rng>::value>* = nullptr) const& return_decltype_MAYTHROW(
+				tc::for_each(tc::must_convert_enc<sink_value_type>(std::forward<Rng>(rng)), *this)
+			)
+
+		private:
+			It& m_it;
+			It m_itEnd;
+		};
+
+		// Strings from exactly sized ranges, e.g., tc::concat(str, tc::as_dec(n)), are allocated once and written without capacity checks.
+		// Like is_range_insertable, only for elements which the checked path accepts as well.
+		template< typename Cont, typename Rng, typename Enable=void >
+		struct is_unchecked_writable final: std::false_type {};
+
+		template< typename Cont, typename Rng >
+		struct is_unchecked_writable<Cont, Rng, std::enable_if_t<
+			tc::is_char<tc::range_value_t<Cont>>::value &&
+			tc::has_size<Rng>::value &&
+			tc::econstructionIMPLICIT==tc::construction_restrictiveness<tc::range_value_t<Cont>, tc::range_value_t<Rng>>::value
+		>> final: std::true_type {};
+
 		template< typename Cont >
 		struct [[nodiscard]] appender_type /*final*/: appender_type_no_reserve<Cont> {
 			using base_ = appender_type_no_reserve<Cont>;
@@ -107,16 +154,60 @@ namespace tc {
 
 			using base_::chunk;
 
+			// Ranges without tc::size(), e.g., filters, may reserve more than needed. Conversions shrink the result afterwards.
 			template< typename Rng, ENABLE_SFINAE, std::enable_if_t<
 				!is_conv_enc_needed<tc::range_value_t<Cont>, Rng>::value &&
 				has_mem_fn_reserve<SFINAE_TYPE(Cont)>::value &&
-				tc::has_size<Rng>::value &&
+				tc::has_size_upper_bound<Rng>::value &&
+				!is_unchecked_writable<SFINAE_TYPE(Cont), Rng>::value &&
 				!is_range_insertable<Cont, Rng>::value
 			>* = nullptr>
 			constexpr auto chunk(Rng&& rng) const& MAYTHROW code_return_decltype(
-				tc::cont_reserve(this->m_cont, this->m_cont.size()+tc::size(rng));,
+				tc::cont_reserve(this->m_cont, this->m_cont.size()+tc::size_upper_bound(rng));,
 				tc::for_each(std::forward<Rng>(rng), tc::base_cast</*SFINAE_TYPE to workaround clang bug*/SFINAE_TYPE(base_)>(*this))
 			)
+
+			// Concatenation with some unsized components, e.g., tc::concat(str, tc::as_dec(n), str): reserve once for all sized components.
+			template< typename Rng, ENABLE_SFINAE, std::enable_if_t<
+				!is_conv_enc_needed<tc::range_value_t<Cont>, Rng>::value &&
+				has_mem_fn_reserve<SFINAE_TYPE(Cont)>::value &&
+				tc::is_concat_range<tc::remove_cvref_t<Rng>>::value &&
+				!tc::has_size_upper_bound<Rng>::value
+			>* = nullptr>
+			auto chunk(Rng&& rng) const& MAYTHROW {
+				std::size_t nSize=0;
+				tc::for_each(rng.m_baserng, [&](auto const& baserng) MAYTHROW {
+					if constexpr( tc::has_size_upper_bound<decltype(*baserng)>::value ) {
+						nSize+=tc::size_upper_bound(*baserng);
+					}
+				});
+				tc::cont_reserve(this->m_cont, this->m_cont.size()+nSize);
+				// Enumerate the components directly, each of which is appended as chunk again.
+				std::forward<Rng>(rng)(*this);
+				return INTEGRAL_CONSTANT(tc::continue_)();
+			}
+
+			template< typename Rng, ENABLE_SFINAE, std::enable_if_t<
+				!is_conv_enc_needed<tc::range_value_t<Cont>, Rng>::value &&
+				has_mem_fn_reserve<SFINAE_TYPE(Cont)>::value &&
+				is_unchecked_writable<SFINAE_TYPE(Cont), Rng>::value &&
+				!is_range_insertable<Cont, Rng>::value
+			>* = nullptr>
+			auto chunk(Rng&& rng) const& MAYTHROW {
+				auto const nOffset=this->m_cont.size();
+				auto const nSize=nOffset+tc::size_raw(rng);
+				tc::cont_reserve(this->m_cont, nSize);
+				NOBADALLOC(this->m_cont.resize(nSize)); // within capacity
+				auto it=tc::begin_next(this->m_cont, nOffset);
+				try {
+					tc::for_each(std::forward<Rng>(rng), unchecked_writer<decltype(it)>(it, tc::end(this->m_cont))); // MAYTHROW
+				} catch(...) {
+					tc::take_first_inplace(this->m_cont, nOffset);
+					throw;
+				}
+				_ASSERT( tc::end(this->m_cont)==it );
+				return INTEGRAL_CONSTANT(tc::continue_)();
+			}
 		};
 
 		template<typename Derived, typename Value>
@@ -154,6 +245,15 @@ namespace tc {
 		return appender(tc::appender_adl::appender_tag, cont);
 	}
 
+	namespace no_adl {
+		template<typename Alloc, typename Enable=void>
+		struct is_allocator final: std::false_type {};
+
+		template<typename Alloc>
+		struct is_allocator<Alloc, tc::void_t<typename Alloc::value_type, decltype(std::declval<Alloc&>().allocate(std::size_t()))>> final: std::true_type {};
+	}
+	using no_adl::is_allocator;
+
 	namespace no_adl {
 		template<typename Cont, typename Rng, typename Enable=void>
 		struct is_appendable_impl: std::false_type {};
@@ -169,6 +269,15 @@ namespace tc {
 	using no_adl::is_appendable;
 
 	namespace append_detail {
+		// Memory reserved by tc::size_upper_bound may be much larger than needed.
+		template<typename Cont>
+		void shrink_excess_capacity(Cont& cont) noexcept {
+			if constexpr( has_mem_fn_shrink_to_fit<Cont>::value && has_mem_fn_capacity<Cont>::value ) {
+				if( cont.size()<cont.capacity()/2 ) {
+					NOBADALLOC(cont.shrink_to_fit());
+				}
+			}
+		}
 
 		template<typename Cont, typename Rng0, typename ... Rng>
 		constexpr void append_impl(Cont& cont, Rng0&& rng0, Rng&& ... rng) noexcept(noexcept(
@@ -273,6 +382,9 @@ namespace tc {
 			static TTarget fn(Rng0&& rng0, RngN&&... rngN) MAYTHROW {
 				TTarget cont;
  				tc::append(cont, std::forward<Rng0>(rng0), std::forward<RngN>(rngN)...);
+				if constexpr( !std::conjunction<tc::has_size<Rng0>, tc::has_size<RngN>...>::value ) {
+					append_detail::shrink_excess_capacity(cont);
+				}
 				return cont;
 			}
 		};
@@ -288,6 +400,15 @@ namespace tc {
 		return make_vector(tc::concat(std::forward<Rng>(rng)...));
 	}
 
+	// make_vector with allocator, e.g., std::pmr::polymorphic_allocator, to put the result into an arena
+	template< typename Alloc, typename... Rng, std::enable_if_t<tc::is_allocator<tc::decay_t<Alloc>>::value && 0<sizeof...(Rng)>* = nullptr >
+	[[nodiscard]] auto make_vector(Alloc&& alloc, Rng&&... rng) MAYTHROW {
+		using value_type = tc::range_value_t<decltype(tc::concat(std::forward<Rng>(rng)...))>;
+		tc::vector<value_type, typename std::allocator_traits<tc::decay_t<Alloc>>::template rebind_alloc<value_type>> vec(std::forward<Alloc>(alloc));
+		tc::append(vec, std::forward<Rng>(rng)...);
+		return vec;
+	}
+
 	DEFINE_FN(make_vector);
 
 	template< typename Rng >
@@ -305,6 +426,18 @@ namespace tc {
 		return tc::explicit_cast<std::basic_string<Char>>(std::forward<Rng>(rng)...);
 	}
 
+	template< typename Char, typename Alloc, typename... Rng, std::enable_if_t<tc::is_allocator<tc::decay_t<Alloc>>::value && 0<sizeof...(Rng)>* = nullptr >
+	[[nodiscard]] auto make_str(Alloc&& alloc, Rng&&... rng) MAYTHROW {
+		std::basic_string<Char, std::char_traits<Char>, typename std::allocator_traits<tc::decay_t<Alloc>>::template rebind_alloc<Char>> str(std::forward<Alloc>(alloc));
+		tc::append(str, std::forward<Rng>(rng)...);
+		return str;
+	}
+
+	template< typename Alloc, typename... Rng, std::enable_if_t<tc::is_allocator<tc::decay_t<Alloc>>::value && 0<sizeof...(Rng)>* = nullptr >
+	[[nodiscard]] auto make_str(Alloc&& alloc, Rng&&... rng) MAYTHROW {
+		return make_str<tc::range_value_t<decltype(tc::concat(std::forward<Rng>(rng)...))>>(std::forward<Alloc>(alloc), std::forward<Rng>(rng)...);
+	}
+
 	template< typename T, typename Rng >
 	[[nodiscard]] auto make_unique_unordered_set(Rng&& rng) MAYTHROW {
 		tc::unordered_set<T> set;
@@ -7,6 +7,8 @@
 // See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
 
 #include "range.t.h"
+#include "join_adaptor.h"
+#include "sparse_adaptor.h"
 
 static_assert(tc::is_appendable<std::string&, char const*>::value);
 static_assert(!tc::is_appendable<std::string&, int>::value);
@@ -45,6 +47,89 @@ UNITTESTDEF(nonreportappendable) {
 #endif
 }
 
+UNITTESTDEF(make_vector_make_str_with_allocator) {
+	unsigned char abBuffer[1024];
+	std::pmr::monotonic_buffer_resource mbr(abBuffer, sizeof(abBuffer), std::pmr::null_memory_resource()); // fails if anything is allocated outside the arena
+
+	tc::vector<int> vecn{1, 2, 3, 4, 5, 6};
+	tc::pmr::vector<int> vecnEven=tc::make_vector(std::pmr::polymorphic_allocator<int>(&mbr), tc::filter(vecn, [](int const n) noexcept { return 0==n%2; }));
+	tc::vector<int> const vecnExpected{2, 4, 6};
+	TEST_RANGE_EQUAL(vecnExpected, vecnEven);
+	_ASSERT(&mbr==vecnEven.get_allocator().resource());
+
+	tc::pmr::basic_string<char> str=tc::make_str(std::pmr::polymorphic_allocator<char>(&mbr), "abc", tc::as_dec(12));
+	TEST_RANGE_EQUAL("abc12", str);
+	_ASSERT(&mbr==str.get_allocator().resource());
+}
+
+UNITTESTDEF(make_vector_reserves_size_upper_bound) {
+	auto const vecn=tc::make_vector(tc::iota(0, 100));
+	auto const fnFilter=[](int const nMod) noexcept {
+		return [nMod](int const n) noexcept { return 0!=n%nMod; };
+	};
+	auto const fnTwice=[](int const n) noexcept { return 2*n; };
+
+	static_assert(!tc::has_size<decltype(tc::filter(vecn, fnFilter(3)))>::value);
+	TEST_EQUAL(100u, tc::size_upper_bound(tc::filter(vecn, fnFilter(3))));
+	TEST_EQUAL(100u, tc::size_upper_bound(tc::transform(tc::filter(vecn, fnFilter(3)), fnTwice)));
+	TEST_EQUAL(110u, tc::size_upper_bound(tc::concat(tc::filter(vecn, fnFilter(3)), tc::take_first(vecn, 10))));
+	tc::vector<decltype(tc::take_first(vecn, 10))> const vecrngn{tc::take_first(vecn, 10), tc::take_first(vecn, 30)};
+	TEST_EQUAL(40u, tc::size_upper_bound(tc::join(vecrngn)));
+	TEST_EQUAL(5u, tc::size_upper_bound(tc::sparse_range(tc::vector<std::pair<std::size_t, int>>{{1, 1}}, 5, 0)));
+
+	// one allocation of the upper bound
+	auto const vecnKept=tc::make_vector(tc::filter(vecn, fnFilter(3)));
+	TEST_EQUAL(66u, vecnKept.size());
+	TEST_EQUAL(100u, vecnKept.capacity());
+
+	// excess capacity is released
+	auto const vecnFew=tc::make_vector(tc::filter(vecn, [](int const n) noexcept { return n<10; }));
+	TEST_EQUAL(10u, vecnFew.size());
+	_ASSERT(vecnFew.capacity()<50);
+}
+
+UNITTESTDEF(append_concat_reserves_once) {
+	auto const vecn=tc::make_vector(tc::iota(0, 50));
+
+	// reserving per component would grow geometrically to 160
+	tc::vector<int> vecnSized;
+	tc::append(vecnSized, vecn, vecn, vecn);
+	TEST_EQUAL(150u, vecnSized.size());
+	TEST_EQUAL(150u, vecnSized.capacity());
+
+	tc::vector<int> vecnPartiallySized;
+	tc::append(vecnPartiallySized, vecn, [](auto sink) noexcept {}, vecn, vecn);
+	TEST_EQUAL(150u, vecnPartiallySized.capacity());
+	tc::append(vecnPartiallySized, [](auto sink) noexcept { sink(-1); });
+	TEST_RANGE_EQUAL(tc::concat(vecn, vecn, vecn, tc::single(-1)), vecnPartiallySized);
+
+	std::string const str(100, 'x');
+	auto const strConcat=tc::make_str(str, tc::as_dec(12), str);
+	TEST_RANGE_EQUAL(tc::concat(str, "12", str), strConcat);
+}
+
+UNITTESTDEF(make_str_format_exact_size) {
+	TEST_EQUAL(1u, tc::size_raw(tc::as_dec(0)));
+	TEST_EQUAL(4u, tc::size_raw(tc::as_dec(-123)));
+	TEST_EQUAL(20u, tc::size_raw(tc::as_dec(std::numeric_limits<std::int64_t>::min())));
+	TEST_EQUAL(20u, tc::size_raw(tc::as_dec(std::numeric_limits<std::uint64_t>::max())));
+	TEST_EQUAL(5u, tc::size_raw(tc::as_padded_dec<5>(42)));
+	TEST_EQUAL(6u, tc::size_raw(tc::as_padded_dec<5>(123456)));
+	TEST_EQUAL(1u, tc::size_raw(tc::as_unpadded_lc_hex(0)));
+	TEST_EQUAL(3u, tc::size_raw(tc::as_unpadded_lc_hex(0x1ab)));
+	TEST_EQUAL(4u, tc::size_raw(tc::as_padded_lc_hex(std::uint16_t(0x1ab))));
+
+	std::string const strPrefix(20, 'x');
+	auto const str=tc::make_str(strPrefix, "id=", tc::as_dec(-42), ", hex=", tc::as_padded_lc_hex(std::uint16_t(0xbeef)));
+	TEST_RANGE_EQUAL(tc::concat(strPrefix, "id=-42, hex=beef"), str);
+	auto const vecch=tc::make_vector(tc::concat(strPrefix, "id=", tc::as_dec(-42)));
+	TEST_RANGE_EQUAL(str, tc::concat(vecch, ", hex=beef"));
+	TEST_EQUAL(vecch.size(), vecch.capacity());
+
+	// the counting sink only enumerates parts without size
+	TEST_EQUAL(25u, tc::size_linear_raw(tc::concat(strPrefix, tc::as_dec(123), [](auto sink) noexcept { sink('a'); sink('b'); })));
+}
+
 #ifdef TC_PRIVATE
 #include "Library/ErrorReporting/decl.h"
 
@@ -0,0 +1,148 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "range_defines.h"
+#include "fd_sink.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace tc {
+	namespace no_adl {
+		struct async_fd_sink;
+		using async_file_appender = basic_file_appender<async_fd_sink>;
+
+		// Double-buffered writer to a file descriptor, which it does not close. The producer fills one buffer while a background thread writes the other.
+		// When the producer fills its buffer before the background write has finished, it waits for it (back-pressure).
+		// Write errors are reported by the next hand-over of a full buffer or by flush().
+		struct async_fd_sink final : tc::nonmovable {
+			static constexpr std::size_t c_nDefaultBufferSize=1024*1024;
+
+			explicit async_fd_sink(int const fd, std::size_t const nBufferSize=c_nDefaultBufferSize) MAYTHROW
+				: m_fd(fd)
+				, m_abFill(new unsigned char[nBufferSize])
+				, m_abWrite(new unsigned char[nBufferSize])
+				, m_nBufferSize(nBufferSize)
+				, m_nBuffered(0)
+				, m_nWrite(0)
+				, m_bWritePending(false)
+				, m_bFailed(false)
+				, m_bStop(false)
+				, m_thread([this]() noexcept { write_loop(); })
+			{
+				_ASSERT( 0<nBufferSize );
+			}
+
+			~async_fd_sink() {
+				try {
+					flush();
+				} catch(tc::file_failure const&) {
+					_ASSERTFALSE; // call flush() before destruction to handle errors
+				}
+				{
+					std::lock_guard<std::mutex> lock(m_mtx);
+					m_bStop=true;
+				}
+				m_cv.notify_all();
+				m_thread.join();
+			}
+
+			async_file_appender appender() & noexcept {
+				return async_file_appender(*this);
+			}
+
+			// Returns once all bytes written so far have reached the file descriptor.
+			void flush() & THROW(tc::file_failure) {
+				if( 0<m_nBuffered ) hand_over();
+				std::unique_lock<std::mutex> lock(m_mtx);
+				m_cv.wait(lock, [&]() noexcept { return !m_bWritePending; });
+				throw_if_failed();
+			}
+
+			void write(unsigned char const b) & THROW(tc::file_failure) {
+				if( m_nBuffered==m_nBufferSize ) hand_over();
+				m_abFill[m_nBuffered++]=b;
+			}
+
+			void write(unsigned char const* pb, std::size_t nSize) & THROW(tc::file_failure) {
+				// The background thread may still read pb after we return, so large chunks are copied as well.
+				for(;;) {
+					std::size_t const nCopy=tc::min(nSize, m_nBufferSize-m_nBuffered);
+					std::memcpy(m_abFill.get()+m_nBuffered, pb, nCopy);
+					m_nBuffered+=nCopy;
+					pb+=nCopy;
+					nSize-=nCopy;
+					if( 0==nSize ) break;
+					hand_over();
+				}
+			}
+
+		private:
+			void throw_if_failed() & THROW(tc::file_failure) {
+				if( m_bFailed ) {
+					m_bFailed=false;
+					throw tc::file_failure();
+				}
+			}
+
+			void hand_over() & THROW(tc::file_failure) {
+				_ASSERT( 0<m_nBuffered );
+				{
+					std::unique_lock<std::mutex> lock(m_mtx);
+					m_cv.wait(lock, [&]() noexcept { return !m_bWritePending; });
+					std::size_t const nBuffered=m_nBuffered;
+					m_nBuffered=0; // on failure, the buffered bytes are lost, but later writes do not repeat them
+					throw_if_failed();
+					std::swap(m_abFill, m_abWrite);
+					m_nWrite=nBuffered;
+					m_bWritePending=true;
+				}
+				m_cv.notify_all();
+			}
+
+			void write_loop() & noexcept {
+				std::unique_lock<std::mutex> lock(m_mtx);
+				for(;;) {
+					m_cv.wait(lock, [&]() noexcept { return m_bWritePending || m_bStop; });
+					if( !m_bWritePending ) return;
+					fd_sink_detail::byte_span span{m_abWrite.get(), m_nWrite};
+					lock.unlock();
+					bool bFailed=false;
+					try {
+						fd_sink_detail::write_all(m_fd, &span, 1);
+					} catch(tc::file_failure const&) {
+						bFailed=true;
+					}
+					lock.lock();
+					m_bFailed=m_bFailed || bFailed;
+					m_bWritePending=false;
+					m_cv.notify_all();
+				}
+			}
+
+			int const m_fd;
+			std::unique_ptr<unsigned char[]> m_abFill; // owned by the producer
+			std::unique_ptr<unsigned char[]> m_abWrite; // owned by the background thread while m_bWritePending
+			std::size_t const m_nBufferSize;
+			std::size_t m_nBuffered;
+
+			std::mutex m_mtx;
+			std::condition_variable m_cv;
+			std::size_t m_nWrite;
+			bool m_bWritePending;
+			bool m_bFailed;
+			bool m_bStop;
+			std::thread m_thread; // last member, so all state is initialized when the thread starts
+		};
+	}
+	using no_adl::async_fd_sink;
+	using no_adl::async_file_appender;
+}
@@ -0,0 +1,316 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "range_defines.h"
+#include "array.h"
+#include "dense_map.h"
+#include "static_vector.h"
+#include "interval.h"
+#include "container.h"
+#include "format.h"
+#include "blob_reader.h"
+#include "for_each.h"
+#include "subrange.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+// Binary snapshots of tc::array, tc::dense_map, tc::static_vector and tc::interval_set in native byte order, to be read back on the same platform:
+//   std::uint32_t number of elements; for tc::dense_map<Key, Value> this is enum_count<Key>, so adding or removing enumerators invalidates old snapshots
+//   if elements are trivially copyable: padding to alignof(element), counted from the start of the record, followed by all elements as one block
+//   otherwise: each element as a record of its own
+// tc::interval_set<T> stores the bounds of its intervals as a block of T, lo and hi alternating.
+
+namespace tc {
+	namespace binary_persistence_detail {
+		template<typename Cont>
+		struct traits final {
+			static constexpr bool c_bContainer=false;
+		};
+
+		template<typename T>
+		constexpr bool is_block_element() noexcept {
+			return std::is_trivially_copyable<T>::value && !traits<T>::c_bContainer;
+		}
+
+		template<typename T>
+		constexpr std::size_t padding() noexcept {
+			return (alignof(T)-sizeof(std::uint32_t)%alignof(T))%alignof(T);
+		}
+
+		template<typename Cont, typename Sink>
+		void save(Cont const& cont, Sink& sink) MAYTHROW;
+
+		template<typename Rng, typename Sink>
+		void save_range_elements(Rng const& rng, Sink& sink) MAYTHROW {
+			if constexpr( is_block_element<tc::range_value_t<Rng>>() ) {
+				tc::for_each(tc::range_as_blob(rng), sink); // THROW(tc::file_failure)
+			} else {
+				tc::for_each(rng, [&](auto const& t) MAYTHROW {
+					save(t, sink); // THROW(tc::file_failure)
+				});
+			}
+		}
+
+		template<typename T, std::size_t N>
+		struct traits<tc::array<T, N>> final {
+			static constexpr bool c_bContainer=true;
+			static constexpr bool c_bFixedSize=true;
+			static constexpr std::size_t c_nMaxSize=N;
+			static constexpr std::size_t c_nValuesPerElement=1;
+			using element_type = T;
+
+			static std::uint32_t count(tc::array<T, N> const&) noexcept {
+				return static_cast<std::uint32_t>(N);
+			}
+
+			template<typename Sink>
+			static void save_elements(tc::array<T, N> const& a, Sink& sink) MAYTHROW {
+				save_range_elements(a, sink); // THROW(tc::file_failure)
+			}
+
+			static tc::array<T, N> load_block(std::uint32_t, unsigned char const* const pb) noexcept {
+				tc::array<T, N> a(boost::container::default_init_t{});
+				std::memcpy(a.data(), pb, N*sizeof(T));
+				return a;
+			}
+
+			template<typename Func>
+			static tc::array<T, N> load_each(std::uint32_t, Func func) MAYTHROW {
+				return tc::array<T, N>(tc::func_tag, [&](std::size_t) MAYTHROW -> T { return func(); });
+			}
+		};
+
+		template<typename Key, typename Value>
+		struct traits<tc::dense_map<Key, Value>> final {
+			static constexpr bool c_bContainer=true;
+			static constexpr bool c_bFixedSize=true;
+			static constexpr std::size_t c_nMaxSize=enum_count<Key>::value;
+			static constexpr std::size_t c_nValuesPerElement=1;
+			using element_type = Value;
+
+			static std::uint32_t count(tc::dense_map<Key, Value> const&) noexcept {
+				return static_cast<std::uint32_t>(c_nMaxSize);
+			}
+
+			template<typename Sink>
+			static void save_elements(tc::dense_map<Key, Value> const& dm, Sink& sink) MAYTHROW {
+				save_range_elements(dm, sink); // THROW(tc::file_failure)
+			}
+
+			static tc::dense_map<Key, Value> load_block(std::uint32_t, unsigned char const* const pb) noexcept {
+				tc::dense_map<Key, Value> dm(boost::container::default_init_t{});
+				std::memcpy(tc::ptr_begin(dm), pb, c_nMaxSize*sizeof(Value));
+				return dm;
+			}
+
+			template<typename Func>
+			static tc::dense_map<Key, Value> load_each(std::uint32_t, Func func) MAYTHROW {
+				return tc::dense_map<Key, Value>(tc::func_tag, [&](Key) MAYTHROW -> Value { return func(); });
+			}
+		};
+
+		template<typename T, tc::static_vector_size_t N>
+		struct traits<tc::static_vector<T, N>> final {
+			static constexpr bool c_bContainer=true;
+			static constexpr bool c_bFixedSize=false;
+			static constexpr std::size_t c_nMaxSize=N;
+			static constexpr std::size_t c_nValuesPerElement=1;
+			using element_type = T;
+
+			static std::uint32_t count(tc::static_vector<T, N> const& vec) noexcept {
+				return vec.size();
+			}
+
+			template<typename Sink>
+			static void save_elements(tc::static_vector<T, N> const& vec, Sink& sink) MAYTHROW {
+				save_range_elements(vec, sink); // THROW(tc::file_failure)
+			}
+
+			static tc::static_vector<T, N> load_block(std::uint32_t const n, unsigned char const* const pb) noexcept {
+				tc::static_vector<T, N> vec;
+				vec.resize(n);
+				std::memcpy(vec.data(), pb, n*sizeof(T));
+				return vec;
+			}
+
+			template<typename Func>
+			static tc::static_vector<T, N> load_each(std::uint32_t const n, Func func) MAYTHROW {
+				tc::static_vector<T, N> vec;
+				for( std::uint32_t i=0; i<n; ++i ) {
+					vec.emplace_back(func());
+				}
+				return vec;
+			}
+		};
+
+		template<typename T, typename TInterval, typename SetOrVectorImpl>
+		struct traits<tc::interval_set<T, TInterval, SetOrVectorImpl>> final {
+			static_assert(std::is_trivially_copyable<T>::value);
+			using interval_set_type = tc::interval_set<T, TInterval, SetOrVectorImpl>;
+
+			static constexpr bool c_bContainer=true;
+			static constexpr bool c_bFixedSize=false;
+			static constexpr std::size_t c_nMaxSize=std::numeric_limits<std::uint32_t>::max();
+			static constexpr std::size_t c_nValuesPerElement=2;
+			using element_type = T;
+
+			static std::uint32_t count(interval_set_type const& intvlset) noexcept {
+				std::size_t n=0;
+				tc::for_each(intvlset, [&](TInterval const&) noexcept { ++n; });
+				_ASSERT( n<=c_nMaxSize );
+				return static_cast<std::uint32_t>(n);
+			}
+
+			// the bounds are collected into blocks, each block is passed to the sink as one chunk
+			template<typename Sink>
+			static void save_elements(interval_set_type const& intvlset, Sink& sink) MAYTHROW {
+				std::array<T, 2*(4096/(2*sizeof(T))+1)> at;
+				std::size_t n=0;
+				auto const Flush=[&]() MAYTHROW {
+					tc::for_each(tc::range_as_blob(tc::counted(tc::as_const(at).data(), n)), sink); // THROW(tc::file_failure)
+					n=0;
+				};
+				tc::for_each(intvlset, [&](TInterval const& intvl) MAYTHROW {
+					at[n++]=intvl[tc::lo];
+					at[n++]=intvl[tc::hi];
+					if( tc::size(at)==n ) Flush();
+				});
+				if( 0<n ) Flush();
+			}
+
+			// Bounds must describe a normalized interval set, i.e., nonempty, sorted and neither overlapping nor touching intervals.
+			static interval_set_type load_block(std::uint32_t const n, unsigned char const* pb) THROW(tc::blob_read_failure) {
+				interval_set_type intvlset;
+				std::optional<T> otHiPrev;
+				for( std::uint32_t i=0; i<n; ++i ) {
+					T tLo;
+					std::memcpy(std::addressof(tLo), pb, sizeof(T));
+					pb+=sizeof(T);
+					T tHi;
+					std::memcpy(std::addressof(tHi), pb, sizeof(T));
+					pb+=sizeof(T);
+					if( !(tLo<tHi) || (otHiPrev && !(*otHiPrev<tLo)) ) throw tc::blob_read_failure();
+					intvlset|=TInterval(tLo, tHi); // appends at the end
+					otHiPrev=tHi;
+				}
+				return intvlset;
+			}
+		};
+
+		template<typename Cont>
+		std::uint32_t read_count(tc::blob_reader& reader) THROW(tc::blob_read_failure) {
+			using traits_t = traits<Cont>;
+			std::uint32_t const n=reader.read<std::uint32_t>();
+			if( traits_t::c_bFixedSize ? traits_t::c_nMaxSize!=n : traits_t::c_nMaxSize<n ) throw tc::blob_read_failure();
+			return n;
+		}
+
+		template<typename Cont>
+		tc::ptr_range<unsigned char const> read_block(tc::blob_reader& reader, std::uint32_t const n) THROW(tc::blob_read_failure) {
+			using traits_t = traits<Cont>;
+			using element_type = typename traits_t::element_type;
+			reader.read_bytes(padding<element_type>());
+			std::uint64_t const nBytes=std::uint64_t(n)*traits_t::c_nValuesPerElement*sizeof(element_type);
+			auto const rngbRemaining=reader.remaining();
+			if( static_cast<std::uint64_t>(tc::ptr_end(rngbRemaining)-tc::ptr_begin(rngbRemaining))<nBytes ) throw tc::blob_read_failure();
+			auto const rngb=reader.read_bytes(static_cast<std::size_t>(nBytes));
+			if constexpr( std::is_same<element_type, bool>::value ) {
+				if( std::any_of(tc::ptr_begin(rngb), tc::ptr_end(rngb), [](unsigned char const b) noexcept { return 1<b; }) ) throw tc::blob_read_failure(); // not a valid bool representation
+			}
+			return rngb;
+		}
+
+		template<typename Cont, typename Sink>
+		void save(Cont const& cont, Sink& sink) MAYTHROW {
+			using traits_t = traits<Cont>;
+			using element_type = typename traits_t::element_type;
+			static_assert(is_block_element<element_type>() || traits<element_type>::c_bContainer, "Elements must be trivially copyable or supported containers.");
+			tc::for_each(tc::as_blob(traits_t::count(cont)), sink); // THROW(tc::file_failure)
+			if constexpr( is_block_element<element_type>() ) {
+				static constexpr std::array<unsigned char, alignof(element_type)> c_abZero{};
+				tc::for_each(tc::counted(c_abZero.data(), padding<element_type>()), sink); // THROW(tc::file_failure)
+			}
+			traits_t::save_elements(cont, sink); // THROW(tc::file_failure)
+		}
+
+		template<typename Cont>
+		Cont load(tc::blob_reader& reader) THROW(tc::blob_read_failure) {
+			using traits_t = traits<Cont>;
+			using element_type = typename traits_t::element_type;
+			std::uint32_t const n=read_count<Cont>(reader);
+			if constexpr( is_block_element<element_type>() ) {
+				return traits_t::load_block(n, tc::ptr_begin(read_block<Cont>(reader, n)));
+			} else {
+				return traits_t::load_each(n, [&]() MAYTHROW { return load<element_type>(reader); });
+			}
+		}
+	}
+
+	namespace no_adl {
+		template<typename Cont>
+		struct [[nodiscard]] as_binary_impl final {
+			using value_type = unsigned char;
+
+			template<typename Rhs>
+			as_binary_impl(aggregate_tag_t, Rhs&& rhs) noexcept
+				: m_cont(aggregate_tag, std::forward<Rhs>(rhs))
+			{}
+
+			template<typename Sink>
+			void operator()(Sink&& sink) const& MAYTHROW {
+				STATICASSERTSAME(tc::sink_value_t<Sink>, unsigned char, "as_binary should only be used on binary sinks.");
+				binary_persistence_detail::save(*m_cont, sink); // THROW(tc::file_failure)
+			}
+
+		private:
+			tc::reference_or_value<Cont> m_cont;
+		};
+	}
+
+	// Snapshot of cont, to be read back by tc::read_binary or tc::read_binary_view
+	template<typename Cont, std::enable_if_t<binary_persistence_detail::traits<tc::remove_cvref_t<Cont>>::c_bContainer>* = nullptr>
+	auto as_binary(Cont&& cont) return_ctor_noexcept(
+		no_adl::as_binary_impl<Cont>,
+		(aggregate_tag, std::forward<Cont>(cont))
+	)
+
+	// inverse of tc::as_binary. Trivially copyable elements are copied with a single memcpy.
+	// Malformed input throws tc::blob_read_failure and leaves the reader unchanged.
+	template<typename Cont>
+	Cont read_binary(tc::blob_reader& reader) THROW(tc::blob_read_failure) {
+		static_assert(binary_persistence_detail::traits<Cont>::c_bContainer);
+		tc::blob_reader readerCopy=reader;
+		auto cont=binary_persistence_detail::load<Cont>(readerCopy);
+		reader=readerCopy;
+		return cont;
+	}
+
+	// Zero-copy alternative to tc::read_binary for containers of trivially copyable elements, e.g., in a tc::mapped_file.
+	// The elements of a tc::dense_map<Key, Value> are ordered by key.
+	// The record must start at an address aligned for the elements, otherwise tc::blob_read_failure is thrown.
+	template<typename Cont>
+	auto read_binary_view(tc::blob_reader& reader) THROW(tc::blob_read_failure) {
+		using traits_t = binary_persistence_detail::traits<Cont>;
+		using element_type = typename traits_t::element_type;
+		static_assert(binary_persistence_detail::is_block_element<element_type>() && 1==traits_t::c_nValuesPerElement);
+		tc::blob_reader readerCopy=reader;
+		std::uint32_t const n=binary_persistence_detail::read_count<Cont>(readerCopy);
+		auto const rngb=binary_persistence_detail::read_block<Cont>(readerCopy, n);
+		if( 0!=reinterpret_cast<std::uintptr_t>(tc::ptr_begin(rngb))%alignof(element_type) ) throw tc::blob_read_failure();
+		reader=readerCopy;
+		return tc::counted(reinterpret_cast<element_type const*>(tc::ptr_begin(rngb)), n);
+	}
+}
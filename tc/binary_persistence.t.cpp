@@ -0,0 +1,85 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "range.h"
+#include "container.h" // tc::vector
+#include "range.t.h"
+#include "binary_persistence.h"
+
+DEFINE_ENUM(
+	PersistedEnum,
+	persistedenum,
+	(RED)(GREEN)(BLUE)
+)
+
+UNITTESTDEF( binary_persistence_round_trip ) {
+	auto const dm=tc::make_dense_map<PersistedEnum>(1.5, -2.0, 3.25);
+	tc::static_vector<std::uint16_t, 8> vecn;
+	tc::cont_emplace_back(vecn, 7);
+	tc::cont_emplace_back(vecn, 0xffff);
+	tc::array<bool, 3> const ab(tc::aggregate_tag, true, false, true);
+	tc::interval_set<int> intvlset;
+	intvlset|=tc::make_interval(1, 3);
+	intvlset|=tc::make_interval(10, 20);
+	intvlset|=tc::make_interval(-5, 0);
+	tc::dense_map<PersistedEnum, tc::static_vector<int, 4>> dmvecn;
+	tc::cont_emplace_back(dmvecn[persistedenumGREEN], 42);
+
+	tc::vector<unsigned char> vecb;
+	tc::append(vecb, tc::as_binary(dm), tc::as_binary(vecn), tc::as_binary(ab), tc::as_binary(intvlset), tc::as_binary(dmvecn));
+
+	tc::blob_reader reader(vecb);
+	auto const dmRead=tc::read_binary<tc::dense_map<PersistedEnum, double>>(reader);
+	_ASSERT( dmRead==dm );
+	auto const vecnRead=tc::read_binary<tc::static_vector<std::uint16_t, 8>>(reader);
+	TEST_RANGE_EQUAL( vecnRead, vecn );
+	auto const abRead=tc::read_binary<tc::array<bool, 3>>(reader);
+	TEST_RANGE_EQUAL( abRead, ab );
+	auto const intvlsetRead=tc::read_binary<tc::interval_set<int>>(reader);
+	_ASSERT( intvlsetRead==intvlset );
+	auto const dmvecnRead=tc::read_binary<tc::dense_map<PersistedEnum, tc::static_vector<int, 4>>>(reader);
+	_ASSERT( tc::empty(dmvecnRead[persistedenumRED]) );
+	TEST_RANGE_EQUAL( dmvecnRead[persistedenumGREEN], dmvecn[persistedenumGREEN] );
+	_ASSERT( reader.at_end() );
+}
+
+UNITTESTDEF( binary_persistence_view ) {
+	auto const dm=tc::make_dense_map<PersistedEnum>(std::uint64_t(1), std::uint64_t(2), std::uint64_t(3));
+	tc::vector<std::uint64_t> vecn; // 8-byte aligned storage
+	tc::vector<unsigned char> vecb;
+	tc::append(vecb, tc::as_binary(dm));
+	vecn.resize((tc::size(vecb)+7)/8);
+	std::memcpy(vecn.data(), vecb.data(), tc::size(vecb));
+
+	tc::blob_reader reader(tc::counted(reinterpret_cast<unsigned char const*>(vecn.data()), tc::size(vecb)));
+	auto const rngn=tc::read_binary_view<tc::dense_map<PersistedEnum, std::uint64_t>>(reader);
+	TEST_RANGE_EQUAL( rngn, dm );
+	_ASSERT( reinterpret_cast<unsigned char const*>(vecn.data())<reinterpret_cast<unsigned char const*>(tc::ptr_begin(rngn)) ); // a view, not a copy
+	_ASSERT( reader.at_end() );
+}
+
+UNITTESTDEF( binary_persistence_mismatch ) {
+	tc::static_vector<int, 8> vecn;
+	for( int i=0; i<5; ++i ) tc::cont_emplace_back(vecn, i);
+	tc::vector<unsigned char> vecb;
+	tc::append(vecb, tc::as_binary(vecn), tc::as_binary(tc::array<double, 2>(tc::aggregate_tag, 1.0, 2.0)));
+
+	tc::blob_reader reader(vecb);
+	try {
+		static_cast<void>(tc::read_binary<tc::static_vector<int, 4>>(reader)); // too many elements
+		_ASSERTFALSE;
+	} catch(tc::blob_read_failure const&) {}
+	auto const anRead=tc::read_binary<tc::array<int, 5>>(reader); // same layout
+	TEST_RANGE_EQUAL( anRead, vecn );
+	try {
+		static_cast<void>(tc::read_binary<tc::dense_map<PersistedEnum, double>>(reader)); // different enum_count
+		_ASSERTFALSE;
+	} catch(tc::blob_read_failure const&) {}
+	auto const adRead=tc::read_binary<tc::array<double, 2>>(reader);
+	TEST_EQUAL( adRead[1], 2.0 );
+}
@@ -16,6 +16,7 @@
 #endif
 
 #include <climits>
+#include <type_traits>
 
 namespace tc {
 	[[nodiscard]] inline int bit_count(unsigned int x) noexcept {
@@ -59,6 +60,31 @@ namespace tc {
 	#endif
 	}
 
+	// 64 bit variants, templates to keep calls with int arguments unambiguous
+	template<typename T, std::enable_if_t<std::is_same<T, unsigned long long>::value>* = nullptr>
+	[[nodiscard]] inline unsigned long index_of_least_significant_bit(T x) noexcept {
+	#ifdef __clang__
+		_ASSERT(0!=x);
+		return __builtin_ctzll(x);
+	#else
+		unsigned long nIndex;
+		VERIFY(_BitScanForward64(&nIndex, x));
+		return nIndex;
+	#endif
+	}
+
+	template<typename T, std::enable_if_t<std::is_same<T, unsigned long long>::value>* = nullptr>
+	[[nodiscard]] inline unsigned long index_of_most_significant_bit(T x) noexcept {
+	#ifdef __clang__
+		_ASSERT(0!=x);
+		return sizeof(unsigned long long)*CHAR_BIT - 1 - __builtin_clzll(x);
+	#else
+		unsigned long nIndex;
+		VERIFY(_BitScanReverse64(&nIndex, x));
+		return nIndex;
+	#endif
+	}
+
 	[[nodiscard]] inline unsigned long most_significant_bit(unsigned long x) noexcept {
 		if( x ) {
 			return 1ul << tc::index_of_most_significant_bit(x);
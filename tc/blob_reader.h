@@ -0,0 +1,191 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "range_defines.h"
+#include "subrange.h"
+#include "bitfield.h"
+#include "endian_blob.h"
+
+#include <boost/endian/conversion.hpp>
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+
+namespace tc {
+	struct blob_read_failure final {};
+
+	namespace no_adl {
+		// Reads what tc::as_blob, tc::size_prefixed and tc::bool_prefixed write, without copying variable-length data.
+		// Reading past the end throws tc::blob_read_failure and leaves the reader unchanged.
+		struct blob_reader final {
+			template<typename Rng, std::enable_if_t<tc::has_ptr_begin<Rng const&>::value>* = nullptr>
+			explicit blob_reader(Rng const& rng) noexcept
+				: m_pb(tc::ptr_begin(tc::range_as_blob(rng)))
+				, m_pbEnd(tc::ptr_end(tc::range_as_blob(rng)))
+			{}
+
+			bool at_end() const& noexcept {
+				return m_pb==m_pbEnd;
+			}
+
+			tc::ptr_range<unsigned char const> remaining() const& noexcept {
+				return tc::make_iterator_range(m_pb, m_pbEnd);
+			}
+
+			tc::ptr_range<unsigned char const> read_bytes(std::size_t const n) & THROW(tc::blob_read_failure) {
+				if( static_cast<std::size_t>(m_pbEnd-m_pb)<n ) throw tc::blob_read_failure();
+				auto const pb=m_pb;
+				m_pb+=n;
+				return tc::make_iterator_range(pb, m_pb);
+			}
+
+			// inverse of tc::as_blob(t)
+			template<typename T>
+			T read() & THROW(tc::blob_read_failure) {
+				static_assert(std::is_trivially_copyable<T>::value);
+				if constexpr( std::is_same<T, bool>::value ) {
+					unsigned char const b=*tc::ptr_begin(peek_bytes(1));
+					if( 1<b ) throw tc::blob_read_failure(); // not a valid bool representation
+				}
+				T t;
+				std::memcpy(std::addressof(t), tc::ptr_begin(read_bytes(sizeof(T))), sizeof(T));
+				return t;
+			}
+
+			// inverse of tc::as_blob_le(t) / tc::as_blob_be(t)
+			template<typename T>
+			T read_le() & THROW(tc::blob_read_failure) {
+				return tc::bit_cast_range_le<T>(read_bytes(sizeof(T)));
+			}
+
+			template<typename T>
+			T read_be() & THROW(tc::blob_read_failure) {
+				return tc::bit_cast_range_be<T>(read_bytes(sizeof(T)));
+			}
+
+			// inverse of tc::bool_prefixed(ot)
+			template<typename T>
+			std::optional<T> read_bool_prefixed() & THROW(tc::blob_read_failure) {
+				auto const pbBegin=m_pb;
+				try {
+					if( read<bool>() ) {
+						return read<T>();
+					} else {
+						return std::nullopt;
+					}
+				} catch(tc::blob_read_failure const&) {
+					m_pb=pbBegin;
+					throw;
+				}
+			}
+
+			// inverse of tc::size_prefixed(rng) for ranges of T: the bytes of the elements, which may not be aligned for T
+			template<typename T>
+			tc::ptr_range<unsigned char const> read_size_prefixed_blob() & THROW(tc::blob_read_failure) {
+				auto const pbBegin=m_pb;
+				std::uint64_t const nBytes=std::uint64_t(read<std::uint32_t>())*sizeof(T);
+				if( static_cast<std::uint64_t>(m_pbEnd-m_pb)<nBytes ) {
+					m_pb=pbBegin;
+					throw tc::blob_read_failure();
+				}
+				return read_bytes(static_cast<std::size_t>(nBytes));
+			}
+
+			// inverse of tc::size_prefixed(rng) for ranges of byte-sized Char, e.g., strings
+			template<typename Char=unsigned char>
+			tc::ptr_range<Char const> read_size_prefixed() & THROW(tc::blob_read_failure) {
+				static_assert(1==sizeof(Char) && std::is_trivially_copyable<Char>::value);
+				auto const rngb=read_size_prefixed_blob<Char>();
+				return tc::make_iterator_range(reinterpret_cast<Char const*>(tc::ptr_begin(rngb)), reinterpret_cast<Char const*>(tc::ptr_end(rngb)));
+			}
+
+			// inverse of tc::as_varint(n)
+			template<typename T>
+			T read_varint() & THROW(tc::blob_read_failure) {
+				static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value);
+				using unsigned_type = std::make_unsigned_t<T>;
+				auto const pbBegin=m_pb;
+				std::uint64_t const n=read_varint_uint64();
+				if constexpr( sizeof(unsigned_type)<sizeof(std::uint64_t) ) {
+					if( 0!=(n>>(sizeof(unsigned_type)*CHAR_BIT)) ) { // does not fit into T
+						m_pb=pbBegin;
+						throw tc::blob_read_failure();
+					}
+				}
+				auto const u=static_cast<unsigned_type>(n);
+				if constexpr( std::is_signed<T>::value ) {
+					return static_cast<T>((u>>1) ^ (unsigned_type(0)-(u&1))); // zigzag
+				} else {
+					return u;
+				}
+			}
+
+			// inverse of tc::varint_prefixed(rng) for ranges of byte-sized Char
+			template<typename Char=unsigned char>
+			tc::ptr_range<Char const> read_varint_prefixed() & THROW(tc::blob_read_failure) {
+				static_assert(1==sizeof(Char) && std::is_trivially_copyable<Char>::value);
+				auto const pbBegin=m_pb;
+				std::uint64_t const n=read_varint_uint64();
+				if( static_cast<std::uint64_t>(m_pbEnd-m_pb)<n ) {
+					m_pb=pbBegin;
+					throw tc::blob_read_failure();
+				}
+				auto const rngb=read_bytes(static_cast<std::size_t>(n));
+				return tc::make_iterator_range(reinterpret_cast<Char const*>(tc::ptr_begin(rngb)), reinterpret_cast<Char const*>(tc::ptr_end(rngb)));
+			}
+
+		private:
+			tc::ptr_range<unsigned char const> peek_bytes(std::size_t const n) const& THROW(tc::blob_read_failure) {
+				if( static_cast<std::size_t>(m_pbEnd-m_pb)<n ) throw tc::blob_read_failure();
+				return tc::make_iterator_range(m_pb, m_pb+n);
+			}
+
+			std::uint64_t read_varint_uint64() & THROW(tc::blob_read_failure) {
+				if( 8<=m_pbEnd-m_pb ) {
+					// Decode up to 8 bytes at once: find the terminating byte and compact the 7-bit groups in a 64-bit register.
+					std::uint64_t n;
+					std::memcpy(&n, m_pb, sizeof(n));
+					n=boost::endian::little_to_native(n);
+					std::uint64_t const nLastByteBits=~n & 0x8080808080808080ull;
+					if( 0!=nLastByteBits ) {
+						std::size_t const nBytes=tc::index_of_least_significant_bit(nLastByteBits)/8+1;
+						if( nBytes<8 ) n&=(std::uint64_t(1)<<(nBytes*8))-1;
+						n&=0x7f7f7f7f7f7f7f7full;
+						n=((n & 0x7f007f007f007f00ull)>>1) | (n & 0x007f007f007f007full);
+						n=((n & 0x3fff00003fff0000ull)>>2) | (n & 0x00003fff00003fffull);
+						n=((n & 0x0fffffff00000000ull)>>4) | (n & 0x000000000fffffffull);
+						m_pb+=nBytes;
+						return n;
+					}
+				}
+				// near the end of the input or longer than 8 bytes
+				std::uint64_t n=0;
+				unsigned char const* pb=m_pb;
+				for( unsigned int nShift=0;; nShift+=7 ) {
+					if( pb==m_pbEnd || 64<=nShift ) throw tc::blob_read_failure();
+					unsigned char const b=*pb;
+					++pb;
+					if( 63==nShift && 1<(b&0x7f) ) throw tc::blob_read_failure(); // overflow
+					n|=std::uint64_t(b&0x7f)<<nShift;
+					if( 0==(b&0x80) ) break;
+				}
+				m_pb=pb;
+				return n;
+			}
+
+			unsigned char const* m_pb;
+			unsigned char const* m_pbEnd;
+		};
+	}
+	using no_adl::blob_reader;
+}
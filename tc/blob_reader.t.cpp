@@ -0,0 +1,114 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "range.h"
+#include "container.h" // tc::vector
+#include "range.t.h"
+#include "blob_reader.h"
+#include "format.h"
+
+UNITTESTDEF( blob_reader_round_trip ) {
+	std::string const str="payload";
+	tc::vector<std::uint16_t> const vecn{1, 2, 0xffff};
+	std::optional<int> const on=-5;
+	std::optional<int> const onEmpty;
+
+	tc::vector<unsigned char> vecb;
+	tc::append(vecb,
+		tc::as_blob(std::uint64_t(42)),
+		tc::size_prefixed(str),
+		tc::size_prefixed(vecn),
+		tc::size_prefixed(tc::empty_range()),
+		tc::bool_prefixed(on),
+		tc::bool_prefixed(onEmpty)
+	);
+
+	tc::blob_reader reader(vecb);
+	TEST_EQUAL( reader.read<std::uint64_t>(), 42u );
+	auto const rngch=reader.read_size_prefixed<char>();
+	TEST_RANGE_EQUAL( rngch, str );
+	_ASSERT( tc::ptr_begin(vecb)<reinterpret_cast<unsigned char const*>(tc::ptr_begin(rngch)) ); // a view, not a copy
+	TEST_EQUAL( tc::size_raw(reader.read_size_prefixed_blob<std::uint16_t>()), 3*sizeof(std::uint16_t) );
+	VERIFY( tc::empty(reader.read_size_prefixed()) );
+	TEST_EQUAL( *reader.read_bool_prefixed<int>(), -5 );
+	VERIFY( !reader.read_bool_prefixed<int>() );
+	_ASSERT( reader.at_end() );
+}
+
+UNITTESTDEF( blob_reader_bounds ) {
+	tc::vector<unsigned char> vecb;
+	tc::append(vecb, tc::as_blob(std::uint32_t(100)), tc::as_blob(std::uint16_t(7)));
+	tc::blob_reader reader(vecb);
+	try {
+		reader.read_size_prefixed();
+		_ASSERTFALSE;
+	} catch(tc::blob_read_failure const&) {}
+	TEST_EQUAL( tc::size_raw(reader.remaining()), 6u ); // unchanged by the failed read
+	TEST_EQUAL( reader.read<std::uint32_t>(), 100u );
+	try {
+		reader.read<std::uint32_t>();
+		_ASSERTFALSE;
+	} catch(tc::blob_read_failure const&) {}
+	TEST_EQUAL( reader.read<std::uint16_t>(), 7u );
+}
+
+UNITTESTDEF( blob_reader_varint ) {
+	TEST_EQUAL( tc::size_raw(tc::as_varint(127u)), 1u );
+	TEST_EQUAL( tc::size_raw(tc::as_varint(128u)), 2u );
+	TEST_EQUAL( tc::size_raw(tc::as_varint(-1)), 1u ); // zigzag
+	TEST_EQUAL( tc::size_raw(tc::as_varint(std::numeric_limits<std::uint64_t>::max())), 10u );
+
+	std::string const str(300, 'x');
+	tc::vector<unsigned char> vecb;
+	tc::append(vecb,
+		tc::as_varint(0u),
+		tc::as_varint(std::numeric_limits<std::uint64_t>::max()),
+		tc::as_varint(std::numeric_limits<int>::min()),
+		tc::as_varint(std::uint64_t(1)<<55), // 8 bytes
+		tc::varint_prefixed(str),
+		tc::as_varint(300u) // decoded byte by byte near the end
+	);
+	TEST_EQUAL( tc::size_raw(vecb), 1+10+5+8+(2+300)+2u );
+
+	tc::blob_reader reader(vecb);
+	TEST_EQUAL( reader.read_varint<unsigned int>(), 0u );
+	TEST_EQUAL( reader.read_varint<std::uint64_t>(), std::numeric_limits<std::uint64_t>::max() );
+	TEST_EQUAL( reader.read_varint<int>(), std::numeric_limits<int>::min() );
+	TEST_EQUAL( reader.read_varint<std::uint64_t>(), std::uint64_t(1)<<55 );
+	TEST_RANGE_EQUAL( reader.read_varint_prefixed<char>(), str );
+	try {
+		reader.read_varint<unsigned char>(); // 300 does not fit
+		_ASSERTFALSE;
+	} catch(tc::blob_read_failure const&) {}
+	TEST_EQUAL( reader.read_varint<unsigned short>(), 300u );
+	_ASSERT( reader.at_end() );
+}
+
+UNITTESTDEF( blob_reader_endian ) {
+	tc::vector<std::uint32_t> vecn;
+	for( std::uint32_t n=0; n<3000; ++n ) tc::cont_emplace_back(vecn, n*0x01010101u);
+	vecn[1]=0x12345678;
+
+	tc::vector<unsigned char> vecb;
+	tc::append(vecb, tc::as_blob_be(std::uint16_t(0x0102)), tc::as_blob_le(std::uint16_t(0x0102)), tc::as_blob_be(1.5), tc::range_as_blob_be(vecn));
+	TEST_EQUAL( tc::size_raw(vecb), 2+2+8+3000*4u );
+	TEST_EQUAL( vecb[0], 1 );
+	TEST_EQUAL( vecb[1], 2 );
+	TEST_EQUAL( vecb[2], 2 );
+	TEST_EQUAL( vecb[3], 1 );
+	TEST_EQUAL( vecb[12+4], 0x12 ); // big endian, crossing swap blocks below
+
+	tc::blob_reader reader(vecb);
+	TEST_EQUAL( reader.read_be<std::uint16_t>(), 0x0102u );
+	TEST_EQUAL( reader.read_le<std::uint16_t>(), 0x0102u );
+	TEST_EQUAL( reader.read_be<double>(), 1.5 );
+	for( std::uint32_t const n : vecn ) {
+		TEST_EQUAL( reader.read_be<std::uint32_t>(), n );
+	}
+	_ASSERT( reader.at_end() );
+}
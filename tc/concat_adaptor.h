@@ -124,6 +124,22 @@ namespace tc {
 					);
 			}
 
+			template< ENABLE_SFINAE, std::enable_if_t<
+				!std::conjunction<tc::has_size<SFINAE_TYPE(Rng)>...>::value &&
+				std::conjunction<tc::has_size_upper_bound<SFINAE_TYPE(Rng)>...>::value
+			>* = nullptr >
+			std::size_t size_upper_bound() const& MAYTHROW {
+				return 
+					tc::accumulate(
+						tc::transform(
+							std::index_sequence_for<Rng...>(),
+							[&](auto nconstIndex) MAYTHROW { return tc::size_upper_bound(*std::get<nconstIndex()>(this->m_baserng)); }
+						),
+						std::size_t(0),
+						fn_assign_plus()
+					);
+			}
+
 			bool empty() const& noexcept {
 				return tc::all_of(m_baserng, [](auto const& rng) noexcept { return tc::empty(*rng); });
 			}
@@ -433,6 +449,41 @@ namespace tc {
 					}
 				}
 			}
+
+			// Within one base range, use its middle_point, so, e.g., binary search on a concatenation of trees stays logarithmic.
+			// Across base ranges, go half the distance if possible, otherwise split the base range of idx.
+			STATIC_FINAL_MOD(
+				template<
+					ENABLE_SFINAE BOOST_PP_COMMA()
+					std::enable_if_t<
+						std::conjunction<tc::has_middle_point<std::remove_reference_t<SFINAE_TYPE(Rng)>>...>::value &&
+						std::conjunction<tc::has_end_index<std::remove_reference_t<SFINAE_TYPE(Rng)>>...>::value
+					>* = nullptr
+				>,
+				middle_point
+			)(index& idx, index const& idxEnd) const& noexcept -> void {
+				_ASSERT(!this->at_end_index(idx));
+				if constexpr (
+					std::conjunction<tc::has_distance_to_index<std::remove_reference_t<Rng>>...>::value &&
+					std::conjunction<tc::has_advance_index<std::remove_reference_t<Rng>>...>::value
+				) {
+					if (idx.index() != idxEnd.index()) {
+						this->advance_index(idx, this->distance_to_index(idx, idxEnd) / 2);
+						return;
+					}
+				}
+				tc::invoke_with_constant<std::index_sequence_for<Rng...>>(
+					[&](auto nconstIndex) noexcept {
+						// idx is not at the end of its base range, so the result is not either and idx stays normalized
+						if (nconstIndex() == idxEnd.index()) {
+							tc::middle_point(*std::get<nconstIndex()>(m_baserng), tc::get<nconstIndex()>(idx), tc::get<nconstIndex()>(idxEnd));
+						} else {
+							tc::middle_point(*std::get<nconstIndex()>(m_baserng), tc::get<nconstIndex()>(idx), tc::end_index(std::get<nconstIndex()>(m_baserng)));
+						}
+					},
+					idx.index()
+				);
+			}
 		};
 	}
 
@@ -11,6 +11,9 @@
 
 #include "concat_adaptor.h"
 
+#include <list>
+#include <set>
+
 struct non_empty_generator {
 	template<typename Func> void operator()(Func func) const { func(1); }
 };
@@ -179,6 +182,48 @@ UNITTESTDEF(ConcatAdvanceToEndIterator) {
 	it += 0;
 }
 
+UNITTESTDEF(concat_middle_point) {
+	tc::vector<int> vecn1{1, 2, 3};
+	tc::vector<int> vecn2{4, 5, 6, 7, 8};
+	auto rng = tc::concat(vecn1, vecn2);
+
+	auto idx = tc::begin_index(rng);
+	tc::middle_point(rng, idx, tc::end_index(rng));
+	_ASSERTEQUAL(tc::dereference_index(rng, idx), 5);
+
+	auto idxEnd = tc::begin_index(rng);
+	tc::advance_index(rng, idxEnd, 2);
+	idx = tc::begin_index(rng);
+	tc::middle_point(rng, idx, idxEnd);
+	_ASSERTEQUAL(tc::dereference_index(rng, idx), 2);
+
+	_ASSERTEQUAL(*tc::lower_bound<tc::return_border>(rng, 6), 6);
+}
+
+UNITTESTDEF(concat_middle_point_bidirectional) {
+	std::set<int> setn{1, 2, 3};
+	std::list<int> lstn{4, 5, 6, 7, 8};
+	auto rng = tc::concat(setn, lstn);
+
+	// No distances, so the middle point is taken by the base range of idx, here its first element, which makes binary search linear.
+	auto idx = tc::begin_index(rng);
+	tc::middle_point(rng, idx, tc::end_index(rng));
+	_ASSERTEQUAL(tc::dereference_index(rng, idx), 1);
+
+	for (int i = 0; i < 3; ++i) tc::increment_index(rng, idx);
+	auto const idxSecond = idx;
+	tc::middle_point(rng, idx, tc::end_index(rng));
+	_ASSERTEQUAL(tc::dereference_index(rng, idx), 4);
+	_ASSERT(tc::equal_index(rng, idxSecond, idx));
+
+	// across the boundary between the base ranges
+	_ASSERTEQUAL(*tc::lower_bound<tc::return_border>(rng, 3), 3);
+	_ASSERTEQUAL(*tc::lower_bound<tc::return_border>(rng, 4), 4);
+	_ASSERTEQUAL(*tc::lower_bound<tc::return_border>(rng, 7), 7);
+	_ASSERT(tc::end(rng) == tc::lower_bound<tc::return_border>(rng, 9));
+	_ASSERTEQUAL(*tc::upper_bound<tc::return_border>(rng, 3), 4);
+}
+
 namespace
 {
 	TC_HAS_EXPR(decrement_operator, (T), --std::declval<T&>());
@@ -18,6 +18,7 @@
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
+#include <memory_resource>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/identity.hpp>
@@ -109,4 +110,26 @@ namespace tc {
 
 	template<typename Key, typename T, typename Compare=tc::less_key, typename Alloc=std::allocator<std::pair<Key const, T>>>
 	using map=std::map<Key, T, Compare, Alloc>;
+
+	// Same containers, but allocating from a std::pmr::memory_resource. Constructed with a std::pmr::monotonic_buffer_resource,
+	// all memory allocated by a computation is released at once when the resource goes out of scope.
+	namespace pmr {
+		template<typename T>
+		using vector=tc::vector<T, std::pmr::polymorphic_allocator<T>>;
+
+		template<typename Char>
+		using basic_string=std::basic_string<Char, std::char_traits<Char>, std::pmr::polymorphic_allocator<Char>>;
+
+		template<typename Key, typename Hash=typename tc::unordered_set<Key>::hasher, typename KeyEqual=typename tc::unordered_set<Key>::key_equal>
+		using unordered_set=tc::unordered_set<Key, Hash, KeyEqual, std::pmr::polymorphic_allocator<Key>>;
+
+		template<typename Key, typename T, typename Hash=typename tc::unordered_map<Key, T>::hasher, typename KeyEqual=typename tc::unordered_map<Key, T>::key_equal>
+		using unordered_map=tc::unordered_map<Key, T, Hash, KeyEqual, std::pmr::polymorphic_allocator<std::pair<Key const, T>>>;
+
+		template<typename Key, typename Compare=tc::less_key>
+		using set=tc::set<Key, Compare, std::pmr::polymorphic_allocator<Key>>;
+
+		template<typename Key, typename T, typename Compare=tc::less_key>
+		using map=tc::map<Key, T, Compare, std::pmr::polymorphic_allocator<std::pair<Key const, T>>>;
+	}
 }
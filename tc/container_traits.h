@@ -35,6 +35,8 @@ TC_HAS_MEM_FN_XXX_TRAIT_DEF(pop_front, &)
 TC_HAS_MEM_FN_XXX_TRAIT_DEF(pop_back, &)
 TC_HAS_MEM_FN_XXX_TRAIT_DEF( hash_function, const&) // indicate the datastructure is a hashset/hashtable
 TC_HAS_MEM_FN_XXX_TRAIT_DEF(capacity, const&)
+TC_HAS_MEM_FN_XXX_TRAIT_DEF(shrink_to_fit, &)
+TC_HAS_MEM_FN_XXX_TRAIT_DEF(size_upper_bound, const&)
 
 BOOST_MPL_HAS_XXX_TRAIT_DEF(efficient_erase)
 
@@ -0,0 +1,232 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "range_defines.h"
+#include "break_or_continue.h"
+#include "subrange.h"
+#include "container.h"
+#include "reference_or_value.h"
+#include "minmax.h"
+#include "for_each.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <thread>
+
+namespace tc {
+	struct csv_dialect final {
+		char m_chSeparator;
+		char m_chQuote;
+	};
+
+	inline constexpr csv_dialect csv_comma{',', '"'};
+	inline constexpr csv_dialect csv_tab{'\t', '"'};
+
+	namespace no_adl {
+		// Field of a CSV row. For quoted fields, raw() excludes the enclosing quotes but still contains doubled quotes.
+		// As a range, the field yields the unescaped characters, so tc::make_str(field) only copies when needed.
+		// Numbers can be parsed from raw(), e.g., by tc::signed_integer_from_string.
+		struct csv_field final {
+			using value_type = char;
+
+			csv_field(tc::ptr_range<char const> rngchRaw, char const chQuote, bool const bEscaped) noexcept
+				: m_rngchRaw(rngchRaw)
+				, m_chQuote(chQuote)
+				, m_bEscaped(bEscaped)
+			{}
+
+			tc::ptr_range<char const> raw() const& noexcept {
+				return m_rngchRaw;
+			}
+
+			// true if raw() contains doubled quotes and differs from the field value
+			bool escaped() const& noexcept {
+				return m_bEscaped;
+			}
+
+			template<typename Sink>
+			tc::break_or_continue operator()(Sink sink) const& MAYTHROW {
+				char const* pch=tc::ptr_begin(m_rngchRaw);
+				char const* const pchEnd=tc::ptr_end(m_rngchRaw);
+				if( m_bEscaped ) {
+					// pass the text up to and including each quote, but skip the second quote of the pair
+					while( auto const pchQuote=static_cast<char const*>(std::memchr(pch, m_chQuote, pchEnd-pch)) ) {
+						_ASSERTE( pchQuote+1!=pchEnd && m_chQuote==pchQuote[1] );
+						RETURN_IF_BREAK(tc::for_each(tc::make_iterator_range(pch, pchQuote+1), sink));
+						pch=pchQuote+2;
+					}
+				}
+				RETURN_IF_BREAK(tc::for_each(tc::make_iterator_range(pch, pchEnd), sink));
+				return tc::continue_;
+			}
+
+		private:
+			tc::ptr_range<char const> m_rngchRaw;
+			char m_chQuote;
+			bool m_bEscaped;
+		};
+	}
+	using no_adl::csv_field;
+
+	namespace csv_detail {
+		inline bool is_field_end(char const ch, csv_dialect const& dialect) noexcept {
+			return dialect.m_chSeparator==ch || '\n'==ch;
+		}
+
+		// Parses the row starting at pch into vecfield and returns the start of the next row.
+		// Malformed input is accepted: an unterminated quote extends to pchEnd, text after a closing quote is ignored up to the end of the field.
+		inline char const* parse_row(char const* pch, char const* const pchEnd, csv_dialect const& dialect, tc::vector<tc::csv_field>& vecfield) noexcept {
+			vecfield.clear();
+			for(;;) {
+				if( pch!=pchEnd && dialect.m_chQuote==*pch ) {
+					char const* const pchBegin=++pch;
+					bool bEscaped=false;
+					for(;;) {
+						pch=static_cast<char const*>(std::memchr(pch, dialect.m_chQuote, pchEnd-pch));
+						if( !pch ) {
+							pch=pchEnd;
+							break;
+						}
+						if( pch+1==pchEnd || dialect.m_chQuote!=pch[1] ) break;
+						bEscaped=true;
+						pch+=2;
+					}
+					tc::cont_emplace_back(vecfield, tc::make_iterator_range(pchBegin, pch), dialect.m_chQuote, bEscaped);
+					if( pch!=pchEnd ) ++pch;
+					while( pch!=pchEnd && !is_field_end(*pch, dialect) ) ++pch;
+				} else {
+					char const* const pchBegin=pch;
+					while( pch!=pchEnd && !is_field_end(*pch, dialect) ) ++pch;
+					char const* pchFieldEnd=pch;
+					if( pchFieldEnd!=pchBegin && '\r'==pchFieldEnd[-1] && (pch==pchEnd || '\n'==*pch) ) --pchFieldEnd;
+					tc::cont_emplace_back(vecfield, tc::make_iterator_range(pchBegin, pchFieldEnd), dialect.m_chQuote, false);
+				}
+				if( pch==pchEnd ) return pch;
+				if( '\n'==*pch ) return pch+1;
+				++pch; // separator
+			}
+		}
+
+		inline bool odd_quote_count(char const* const pchBegin, char const* const pchEnd, char const chQuote) noexcept {
+			return 0!=std::count(pchBegin, pchEnd, chQuote)%2;
+		}
+
+		// Start of the first row after pch, which is inside quotes if bInQuotes.
+		inline char const* next_row_begin(char const* pch, char const* const pchEnd, char const chQuote, bool bInQuotes) noexcept {
+			for( ; pch!=pchEnd; ++pch ) {
+				if( chQuote==*pch ) {
+					bInQuotes=!bInQuotes;
+				} else if( '\n'==*pch && !bInQuotes ) {
+					return pch+1;
+				}
+			}
+			return pchEnd;
+		}
+
+		// Calls func(i) for i in [0, n) on n threads, including the calling one.
+		template<typename Func>
+		void run_parallel(std::size_t const n, Func const& func) MAYTHROW {
+			tc::vector<std::exception_ptr> vecexcept(n);
+			auto const RunCatch=[&](std::size_t const i) noexcept {
+				try {
+					func(i);
+				} catch(...) {
+					vecexcept[i]=std::current_exception();
+				}
+			};
+			tc::vector<std::thread> vecthread;
+			vecthread.reserve(n-1);
+			for( std::size_t i=1; i<n; ++i ) {
+				tc::cont_emplace_back(vecthread, RunCatch, i);
+			}
+			RunCatch(0);
+			for( std::thread& thread : vecthread ) thread.join();
+			for( std::exception_ptr const& except : vecexcept ) {
+				if( except ) std::rethrow_exception(except);
+			}
+		}
+	}
+
+	namespace no_adl {
+		// Rows of CSV text in a contiguous char range. The sink gets the fields of each row as tc::vector<tc::csv_field> const&, which is reused for the next row.
+		template<typename Rng>
+		struct [[nodiscard]] csv_rows_adaptor final {
+			using value_type = tc::vector<tc::csv_field>;
+
+			template<typename Rhs>
+			explicit csv_rows_adaptor(aggregate_tag_t, Rhs&& rhs, csv_dialect const& dialect) noexcept
+				: m_rng(aggregate_tag, std::forward<Rhs>(rhs))
+				, m_dialect(dialect)
+			{}
+
+			template<typename Sink>
+			tc::break_or_continue operator()(Sink sink) const& MAYTHROW {
+				char const* pch=tc::ptr_begin(*m_rng);
+				char const* const pchEnd=tc::ptr_end(*m_rng);
+				tc::vector<tc::csv_field> vecfield;
+				while( pch!=pchEnd ) {
+					pch=csv_detail::parse_row(pch, pchEnd, m_dialect, vecfield);
+					RETURN_IF_BREAK(tc::continue_if_not_break(sink, tc::as_const(vecfield)));
+				}
+				return tc::continue_;
+			}
+
+		private:
+			tc::reference_or_value<Rng> m_rng;
+			csv_dialect m_dialect;
+		};
+	}
+
+	template<typename Rng, std::enable_if_t<tc::has_ptr_begin<Rng>::value>* = nullptr>
+	auto csv_rows(Rng&& rng, csv_dialect const& dialect=tc::csv_comma) return_ctor_noexcept(
+		no_adl::csv_rows_adaptor<Rng>,
+		(aggregate_tag, std::forward<Rng>(rng), dialect)
+	)
+
+	// Splits rng into nChunks row-aligned chunks and calls func(iChunk, vecfield) for each row, concurrently for different chunks.
+	// Within a chunk, rows are passed in order. Chunk boundaries are found after counting quotes in parallel, so newlines in quoted fields are handled.
+	template<typename Rng, typename Func>
+	void parallel_for_each_csv_row(Rng const& rng, Func const& func, csv_dialect const& dialect=tc::csv_comma, std::size_t nChunks=std::thread::hardware_concurrency()) MAYTHROW {
+		constexpr std::size_t c_nMinChunkSize=1024*1024;
+		char const* const pchBegin=tc::ptr_begin(rng);
+		char const* const pchEnd=tc::ptr_end(rng);
+		std::size_t const nSize=pchEnd-pchBegin;
+		nChunks=tc::max(tc::min(nChunks, nSize/c_nMinChunkSize), std::size_t(1));
+
+		auto const Split=[&](std::size_t const i) noexcept {
+			return pchBegin+nSize/nChunks*i;
+		};
+		tc::vector<char> vecbOddQuotes(nChunks); // not tc::vector<bool>, elements are written concurrently
+		csv_detail::run_parallel(nChunks, [&](std::size_t const i) noexcept {
+			vecbOddQuotes[i]=csv_detail::odd_quote_count(Split(i), i+1==nChunks ? pchEnd : Split(i+1), dialect.m_chQuote);
+		});
+
+		tc::vector<char const*> vecpchRow(nChunks+1);
+		vecpchRow[0]=pchBegin;
+		vecpchRow[nChunks]=pchEnd;
+		bool bInQuotes=false;
+		for( std::size_t i=1; i<nChunks; ++i ) {
+			bInQuotes=bInQuotes!=static_cast<bool>(vecbOddQuotes[i-1]);
+			// Start one character early to detect a row beginning exactly at the split point.
+			char const* const pch=Split(i)-1;
+			vecpchRow[i]=tc::max(
+				csv_detail::next_row_begin(pch, pchEnd, dialect.m_chQuote, bInQuotes!=(dialect.m_chQuote==*pch)),
+				vecpchRow[i-1]
+			);
+		}
+
+		csv_detail::run_parallel(nChunks, [&](std::size_t const i) MAYTHROW {
+			tc::for_each(tc::csv_rows(tc::make_iterator_range(vecpchRow[i], vecpchRow[i+1]), dialect), [&](tc::vector<tc::csv_field> const& vecfield) MAYTHROW {
+				func(i, vecfield);
+			});
+		});
+	}
+}
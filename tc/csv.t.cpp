@@ -0,0 +1,56 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "range.h"
+#include "container.h" // tc::vector
+#include "range.t.h"
+#include "csv.h"
+#include "format.h"
+#include "for_each_xxx.h"
+
+#include <atomic>
+
+UNITTESTDEF( csv_rows_quoted_fields ) {
+	std::string const str="id,name,comment\r\n1,\"Smith, J\",\"said \"\"hi\"\"\"\n2,x,\"multi\nline\"\n3,,";
+	tc::vector<std::string> vecstr;
+	tc::for_each(tc::csv_rows(str), [&](tc::vector<tc::csv_field> const& vecfield) noexcept {
+		tc::cont_emplace_back(vecstr, tc::make_str(tc::join_separated(vecfield, "|")));
+	});
+	TEST_EQUAL( tc::size_raw(vecstr), 4u );
+	TEST_RANGE_EQUAL( vecstr[0], "id|name|comment" );
+	TEST_RANGE_EQUAL( vecstr[1], "1|Smith, J|said \"hi\"" );
+	TEST_RANGE_EQUAL( vecstr[2], "2|x|multi\nline" );
+	TEST_RANGE_EQUAL( vecstr[3], "3||" );
+
+	int nSum=0;
+	tc::for_each(tc::csv_rows(tc::make_str("a\tb\n", "17\t25\n"), tc::csv_tab), [&](tc::vector<tc::csv_field> const& vecfield) noexcept {
+		if( !vecfield[0].escaped() && "a"!=tc::make_str(vecfield[0]) ) {
+			nSum+=tc::unsigned_integer_from_string<int>(vecfield[0].raw())+tc::unsigned_integer_from_string<int>(vecfield[1].raw());
+		}
+	});
+	TEST_EQUAL( nSum, 42 );
+}
+
+UNITTESTDEF( csv_parallel_chunks ) {
+	// rows with quoted newlines around the chunk boundaries
+	std::string str;
+	int const nRows=200000;
+	for( int i=0; i<nRows; ++i ) {
+		tc::append(str, tc::as_dec(i), ",\"x\ny\"\n");
+	}
+	std::atomic<long long> nSum(0);
+	std::atomic<int> nCount(0);
+	tc::parallel_for_each_csv_row(str, [&](std::size_t, tc::vector<tc::csv_field> const& vecfield) noexcept {
+		_ASSERTEQUAL( tc::size(vecfield), 2u );
+		TEST_RANGE_EQUAL( vecfield[1].raw(), "x\ny" );
+		nSum+=tc::unsigned_integer_from_string<int>(vecfield[0].raw());
+		++nCount;
+	}, tc::csv_comma, 4);
+	TEST_EQUAL( nCount.load(), nRows );
+	TEST_EQUAL( nSum.load(), static_cast<long long>(nRows)*(nRows-1)/2 );
+}
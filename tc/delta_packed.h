@@ -0,0 +1,293 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "range_defines.h"
+#include "format.h"
+#include "blob_reader.h"
+#include "bitfield.h"
+#include "size.h"
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// Delta + bit-packing codec for (preferably sorted) integer ranges:
+//   varint total number of elements
+//   per block of up to 128 elements:
+//     varint difference of the first element to the last element of the previous block (or to 0)
+//     byte b: number of bits per difference
+//     differences of the remaining elements to their predecessors, b bits each, in 4 interleaved lanes of little endian 64-bit words:
+//       difference i is in lane i%4, least significant bit first, and word k of lane l is the (4*k+l)-th word; each lane is padded to whole words
+// Differences are computed modulo 2^n on the unsigned type, so unsorted input round-trips, but compresses badly.
+
+namespace tc {
+	namespace delta_packed_detail {
+		constexpr std::size_t c_nBlockSize=128;
+
+		template<typename T>
+		using unsigned_t = std::make_unsigned_t<T>;
+
+		// The differences of a block are packed in c_nLanes interleaved lanes: difference i goes to lane i%c_nLanes, whose
+		// bit stream is stored in every c_nLanes-th 64-bit word. All lanes shift by the same amounts, so each row of c_nLanes
+		// differences is packed by the same SIMD shifts and ors. The kernels are instantiated for each bit width, which makes all
+		// shift amounts compile-time constants, and always process c_nRows rows, so a partial block is padded with zeros.
+		constexpr std::size_t c_nLanes=4;
+		constexpr std::size_t c_nRows=c_nBlockSize/c_nLanes;
+		static_assert(0==c_nBlockSize%c_nLanes);
+
+		template<unsigned int nBits>
+		void pack_block(std::uint64_t* const anWord, std::uint64_t const* const an) noexcept {
+			if constexpr( 0!=nBits ) {
+				for( std::size_t iRow=0; iRow<c_nRows; ++iRow ) {
+					std::size_t const nBit=iRow*nBits;
+					unsigned int const nShift=nBit%64;
+					std::uint64_t* const pnWord=anWord+nBit/64*c_nLanes;
+					std::uint64_t const* const pnValue=an+iRow*c_nLanes;
+					for( std::size_t iLane=0; iLane<c_nLanes; ++iLane ) {
+						pnWord[iLane]|=pnValue[iLane]<<nShift;
+					}
+					if( 64<nShift+nBits ) {
+						for( std::size_t iLane=0; iLane<c_nLanes; ++iLane ) {
+							pnWord[c_nLanes+iLane]|=pnValue[iLane]>>(64-nShift);
+						}
+					}
+				}
+			}
+		}
+
+		template<unsigned int nBits>
+		void unpack_block(std::uint64_t* const an, std::uint64_t const* const anWord) noexcept {
+			constexpr std::uint64_t c_nMask=64==nBits ? ~std::uint64_t(0) : (std::uint64_t(1)<<nBits)-1;
+			for( std::size_t iRow=0; iRow<c_nRows; ++iRow ) {
+				std::size_t const nBit=iRow*nBits;
+				unsigned int const nShift=nBit%64;
+				std::uint64_t const* const pnWord=anWord+nBit/64*c_nLanes;
+				std::uint64_t* const pnValue=an+iRow*c_nLanes;
+				for( std::size_t iLane=0; iLane<c_nLanes; ++iLane ) {
+					pnValue[iLane]=(pnWord[iLane]>>nShift)&c_nMask;
+				}
+				if( 64<nShift+nBits ) {
+					for( std::size_t iLane=0; iLane<c_nLanes; ++iLane ) {
+						pnValue[iLane]|=(pnWord[c_nLanes+iLane]<<(64-nShift))&c_nMask;
+					}
+				}
+			}
+		}
+
+		using pack_block_t = void(*)(std::uint64_t*, std::uint64_t const*) noexcept;
+		using unpack_block_t = void(*)(std::uint64_t*, std::uint64_t const*) noexcept;
+
+		template<std::size_t... nBits>
+		constexpr std::array<pack_block_t, sizeof...(nBits)> make_pack_block_table(std::index_sequence<nBits...>) noexcept {
+			return {{&pack_block<nBits>...}};
+		}
+
+		template<std::size_t... nBits>
+		constexpr std::array<unpack_block_t, sizeof...(nBits)> make_unpack_block_table(std::index_sequence<nBits...>) noexcept {
+			return {{&unpack_block<nBits>...}};
+		}
+
+		// indexed by the number of bits per difference
+		inline constexpr auto c_apfnPackBlock=make_pack_block_table(std::make_index_sequence<65>());
+		inline constexpr auto c_apfnUnpackBlock=make_unpack_block_table(std::make_index_sequence<65>());
+
+		struct packed_words final {
+			std::array<std::uint64_t, c_nBlockSize> m_an; // b<=64 bits for c_nRows rows in each lane
+
+			packed_words() noexcept : m_an() {}
+
+			// an holds c_nBlockSize differences, which are zero beyond the n actual ones
+			void pack(std::uint64_t const* const an, unsigned int const nBits) & noexcept {
+				c_apfnPackBlock[nBits](m_an.data(), an);
+			}
+
+			void unpack(std::uint64_t* const an, unsigned int const nBits) const& noexcept {
+				c_apfnUnpackBlock[nBits](an, m_an.data());
+			}
+
+			// whole words in each lane, for the rows holding n differences
+			static std::size_t byte_count(std::size_t const n, unsigned int const nBits) noexcept {
+				std::size_t const nRows=(n+c_nLanes-1)/c_nLanes;
+				return (nRows*nBits+63)/64*c_nLanes*sizeof(std::uint64_t);
+			}
+
+			// words in little endian order
+			void to_bytes(unsigned char* const pb, std::size_t const nBytes) & noexcept {
+				for( std::uint64_t& n : m_an ) boost::endian::native_to_little_inplace(n);
+				std::memcpy(pb, m_an.data(), nBytes);
+			}
+
+			void from_bytes(unsigned char const* const pb, std::size_t const nBytes) & noexcept {
+				std::memcpy(m_an.data(), pb, nBytes);
+				for( std::uint64_t& n : m_an ) boost::endian::little_to_native_inplace(n);
+			}
+		};
+
+		// Sink writing the bytes of tc::as_varint into a buffer, which must be large enough
+		struct byte_buffer_sink /*final*/ {
+			using sink_value_type = unsigned char;
+
+			void operator()(unsigned char const b) const& noexcept {
+				m_pb[(*m_pnBytes)++]=b;
+			}
+
+			unsigned char* m_pb;
+			std::size_t* m_pnBytes;
+		};
+
+		inline unsigned int bit_width(std::uint64_t const n) noexcept {
+			return 0==n ? 0 : static_cast<unsigned int>(tc::index_of_most_significant_bit(static_cast<unsigned long long>(n)))+1;
+		}
+	}
+
+	namespace no_adl {
+		template<typename Rng>
+		struct [[nodiscard]] delta_packed_impl {
+			using value_type = unsigned char;
+
+			template<typename Rhs>
+			delta_packed_impl(aggregate_tag_t, Rhs&& rhs) noexcept
+				: m_rng(aggregate_tag, std::forward<Rhs>(rhs))
+			{}
+
+			template<typename Sink>
+			void operator()(Sink&& sink) const& MAYTHROW {
+				STATICASSERTSAME(tc::sink_value_t<Sink>, unsigned char, "as_delta_packed should only be used on binary sinks.");
+				using namespace delta_packed_detail;
+				using unsigned_type = unsigned_t<tc::range_value_t<Rng>>;
+
+				tc::for_each(tc::as_varint(tc::implicit_cast<std::size_t>(tc::size(*m_rng))), sink); // THROW(tc::file_failure)
+
+				std::array<std::uint64_t, 1+c_nBlockSize> an; // the packed differences start at an[1]
+				std::size_t n=0;
+				unsigned_type nPrev=0;
+				auto const FlushBlock=[&]() MAYTHROW {
+					// an[0] is written as varint, the rest is packed
+					std::uint64_t nOr=0;
+					for( std::size_t i=1; i<n; ++i ) nOr|=an[i];
+					unsigned int const nBits=bit_width(nOr);
+					std::fill(tc::begin_next(an, n), tc::end(an), 0); // padding of a partial block
+					packed_words words;
+					words.pack(tc::as_const(an).data()+1, nBits);
+					std::array<unsigned char, 10+1+c_nBlockSize*sizeof(std::uint64_t)> ab;
+					std::size_t nBytes=0;
+					tc::for_each(tc::as_varint(an[0]), byte_buffer_sink{ab.data(), &nBytes});
+					ab[nBytes++]=static_cast<unsigned char>(nBits);
+					std::size_t const nPacked=packed_words::byte_count(n-1, nBits);
+					words.to_bytes(ab.data()+nBytes, nPacked);
+					nBytes+=nPacked;
+					tc::for_each(tc::counted(tc::as_const(ab).data(), nBytes), sink); // one chunk per block, THROW(tc::file_failure)
+					n=0;
+				};
+				tc::for_each(*m_rng, [&](auto const t) MAYTHROW {
+					auto const nValue=static_cast<unsigned_type>(t);
+					an[n++]=static_cast<unsigned_type>(nValue-nPrev);
+					nPrev=nValue;
+					if( c_nBlockSize==n ) FlushBlock();
+				});
+				if( 0<n ) FlushBlock();
+			}
+
+		private:
+			tc::reference_or_value<Rng> m_rng;
+		};
+	}
+
+	// Binary encoding of an integer range, best for sorted ranges with small differences, e.g., the result of tc::sort_unique_range.
+	template<typename Rng, std::enable_if_t<std::is_integral<tc::range_value_t<Rng>>::value>* = nullptr>
+	auto as_delta_packed(Rng&& rng) return_ctor_noexcept(
+		no_adl::delta_packed_impl<Rng>,
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+
+	namespace no_adl {
+		// Decodes tc::as_delta_packed one block at a time. Throws tc::blob_read_failure on malformed input.
+		template<typename T>
+		struct delta_packed_decoder final {
+			static_assert(std::is_integral<T>::value);
+
+			explicit delta_packed_decoder(tc::ptr_range<unsigned char const> rngb) THROW(tc::blob_read_failure)
+				: m_reader(rngb)
+				, m_nRemaining(m_reader.read_varint<std::size_t>())
+				, m_nPrev(0)
+			{}
+
+			std::size_t remaining() const& noexcept {
+				return m_nRemaining;
+			}
+
+			// Returns the next block of at most 128 elements, which is valid until the next call, or an empty range at the end.
+			tc::ptr_range<T const> next_block() & THROW(tc::blob_read_failure) {
+				using namespace delta_packed_detail;
+				std::size_t const n=tc::min(m_nRemaining, c_nBlockSize);
+				if( 0<n ) {
+					std::array<std::uint64_t, 1+c_nBlockSize> an;
+					an[0]=m_reader.read_varint<std::uint64_t>();
+					unsigned int const nBits=m_reader.read<unsigned char>();
+					if( sizeof(T)*CHAR_BIT<nBits ) throw tc::blob_read_failure();
+					packed_words words;
+					words.from_bytes(tc::ptr_begin(m_reader.read_bytes(packed_words::byte_count(n-1, nBits))), packed_words::byte_count(n-1, nBits));
+					words.unpack(an.data()+1, nBits);
+					for( std::size_t i=0; i<n; ++i ) { // prefix sum
+						m_nPrev+=static_cast<unsigned_t<T>>(an[i]);
+						m_at[i]=static_cast<T>(m_nPrev);
+					}
+					m_nRemaining-=n;
+				}
+				return tc::make_iterator_range(tc::as_const(m_at).data(), tc::as_const(m_at).data()+n);
+			}
+
+			// unread input after the last block
+			tc::ptr_range<unsigned char const> rest() const& noexcept {
+				return m_reader.remaining();
+			}
+
+		private:
+			tc::blob_reader m_reader;
+			std::size_t m_nRemaining;
+			delta_packed_detail::unsigned_t<T> m_nPrev;
+			std::array<T, delta_packed_detail::c_nBlockSize> m_at;
+		};
+
+		template<typename T>
+		struct [[nodiscard]] delta_packed_range final {
+			using value_type = T;
+
+			explicit delta_packed_range(tc::ptr_range<unsigned char const> rngb) noexcept
+				: m_rngb(rngb)
+			{}
+
+			template<typename Sink>
+			tc::break_or_continue operator()(Sink sink) const& MAYTHROW {
+				delta_packed_decoder<T> decoder(m_rngb); // THROW(tc::blob_read_failure)
+				while( 0<decoder.remaining() ) {
+					RETURN_IF_BREAK(tc::for_each(decoder.next_block(), sink)); // whole blocks as chunks
+				}
+				return tc::continue_;
+			}
+
+		private:
+			tc::ptr_range<unsigned char const> m_rngb;
+		};
+	}
+	using no_adl::delta_packed_decoder;
+
+	// Generator of the elements encoded by tc::as_delta_packed
+	template<typename T, typename Rng, std::enable_if_t<tc::has_ptr_begin<Rng const&>::value>* = nullptr>
+	auto delta_packed_range(Rng const& rngb) noexcept {
+		return no_adl::delta_packed_range<T>(tc::range_as_blob(rngb));
+	}
+}
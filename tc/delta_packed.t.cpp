@@ -0,0 +1,65 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "range.h"
+#include "container.h" // tc::vector
+#include "range.t.h"
+#include "delta_packed.h"
+
+UNITTESTDEF( delta_packed_round_trip ) {
+	tc::vector<std::uint32_t> vecn;
+	std::uint32_t n=1000000;
+	for( int i=0; i<1000; ++i ) {
+		n+=1+i%7;
+		tc::cont_emplace_back(vecn, n);
+	}
+	vecn[500]=vecn[499]+100000; // one large gap
+	for( std::size_t i=501; i<tc::size(vecn); ++i ) vecn[i]+=100000;
+
+	tc::vector<unsigned char> vecb;
+	tc::append(vecb, tc::as_delta_packed(vecn));
+	_ASSERT( tc::size(vecb)*4 < tc::size(vecn)*sizeof(std::uint32_t) );
+	TEST_RANGE_EQUAL( tc::delta_packed_range<std::uint32_t>(vecb), vecn );
+
+	tc::delta_packed_decoder<std::uint32_t> decoder(tc::range_as_blob(vecb));
+	TEST_EQUAL( decoder.remaining(), 1000u );
+	TEST_RANGE_EQUAL( decoder.next_block(), tc::take_first(vecn, 128) );
+	TEST_EQUAL( decoder.remaining(), 1000u-128 );
+}
+
+UNITTESTDEF( delta_packed_all_bit_widths ) {
+	for( unsigned int nBits=0; nBits<=64; ++nBits ) {
+		std::uint64_t const nMaxDiff=64==nBits ? ~std::uint64_t(0) : (std::uint64_t(1)<<nBits)-1;
+		tc::vector<std::uint64_t> vecn;
+		std::uint64_t n=0;
+		for( std::size_t i=0; i<tc::delta_packed_detail::c_nBlockSize+nBits; ++i ) { // the second block has a varying number of rows
+			n+=0==i%3 ? nMaxDiff : nMaxDiff/2;
+			tc::cont_emplace_back(vecn, n);
+		}
+		tc::vector<unsigned char> vecb;
+		tc::append(vecb, tc::as_delta_packed(vecn));
+		TEST_RANGE_EQUAL( tc::delta_packed_range<std::uint64_t>(vecb), vecn );
+	}
+}
+
+UNITTESTDEF( delta_packed_edge_cases ) {
+	tc::vector<unsigned char> vecb;
+	tc::append(vecb, tc::as_delta_packed(tc::vector<int>()));
+	_ASSERT( tc::empty(tc::make_vector(tc::delta_packed_range<int>(vecb))) );
+
+	tc::vector<std::int64_t> const vecn{-5, -5, std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max(), 0};
+	vecb.clear();
+	tc::append(vecb, tc::as_delta_packed(vecn));
+	TEST_RANGE_EQUAL( tc::delta_packed_range<std::int64_t>(vecb), vecn );
+
+	tc::take_first_inplace(vecb, tc::size(vecb)-1); // truncated input
+	try {
+		tc::make_vector(tc::delta_packed_range<std::int64_t>(vecb));
+		_ASSERTFALSE;
+	} catch(tc::blob_read_failure const&) {}
+}
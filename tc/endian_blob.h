@@ -0,0 +1,150 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "range_defines.h"
+#include "bit_cast.h"
+#include "subrange.h"
+#include "for_each.h"
+#include "minmax.h"
+#include "reference_or_value.h"
+
+#include <boost/endian/conversion.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace tc {
+	namespace endian_detail {
+		template<std::size_t N> struct uint_of_size;
+		template<> struct uint_of_size<1> final { using type = std::uint8_t; };
+		template<> struct uint_of_size<2> final { using type = std::uint16_t; };
+		template<> struct uint_of_size<4> final { using type = std::uint32_t; };
+		template<> struct uint_of_size<8> final { using type = std::uint64_t; };
+
+		// also for floating point and enum types
+		template<typename T>
+		T byteswap(T const& t) noexcept {
+			using uint_type = typename uint_of_size<sizeof(T)>::type;
+			return tc::bit_cast<T>(boost::endian::endian_reverse(tc::bit_cast<uint_type>(t)));
+		}
+
+		template<boost::endian::order order, typename T>
+		constexpr bool needs_byteswap() noexcept {
+			static_assert(std::is_trivially_copyable<T>::value);
+			return 1<sizeof(T) && boost::endian::order::native!=order;
+		}
+
+		template<boost::endian::order order, typename T>
+		auto as_blob(T&& t) noexcept {
+			if constexpr( needs_byteswap<order, tc::remove_cvref_t<T>>() ) {
+				std::array<unsigned char, sizeof(T)> ab;
+				auto const tSwapped=byteswap(t);
+				std::memcpy(ab.data(), std::addressof(tSwapped), sizeof(tSwapped));
+				return ab;
+			} else {
+				return tc::as_blob(/* no std::forward<T> */ t);
+			}
+		}
+
+		template<boost::endian::order order, typename Dst>
+		Dst bit_cast_range(tc::ptr_range<unsigned char const> src) noexcept {
+			auto const dst=tc::bit_cast_range<Dst>(src);
+			if constexpr( needs_byteswap<order, Dst>() ) {
+				return byteswap(dst);
+			} else {
+				return dst;
+			}
+		}
+	}
+
+	namespace no_adl {
+		// Bytes of a contiguous range with each element byte-swapped. Elements are swapped in blocks, in a loop simple enough to be vectorized,
+		// and each block is passed to the sink as one chunk.
+		template<typename Rng>
+		struct [[nodiscard]] byteswapped_blob_adaptor final {
+			using value_type = unsigned char;
+
+			template<typename Rhs>
+			explicit byteswapped_blob_adaptor(aggregate_tag_t, Rhs&& rhs) noexcept
+				: m_rng(aggregate_tag, std::forward<Rhs>(rhs))
+			{}
+
+			template<typename Sink>
+			tc::break_or_continue operator()(Sink sink) const& MAYTHROW {
+				using value_t = tc::range_value_t<Rng>;
+				std::array<value_t, 4096/sizeof(value_t)> at;
+				auto pt=tc::ptr_begin(*m_rng);
+				auto const ptEnd=tc::ptr_end(*m_rng);
+				while( pt!=ptEnd ) {
+					std::size_t const n=tc::min(tc::size(at), static_cast<std::size_t>(ptEnd-pt));
+					for( std::size_t i=0; i<n; ++i ) {
+						at[i]=endian_detail::byteswap(pt[i]);
+					}
+					RETURN_IF_BREAK(tc::for_each(tc::range_as_blob(tc::counted(tc::as_const(at).data(), n)), sink));
+					pt+=n;
+				}
+				return tc::continue_;
+			}
+
+			std::size_t size() const& noexcept {
+				return tc::size(*m_rng)*sizeof(tc::range_value_t<Rng>);
+			}
+
+		private:
+			tc::reference_or_value<Rng> m_rng;
+		};
+	}
+
+	namespace endian_detail {
+		template<boost::endian::order order, typename Rng>
+		auto range_as_blob(Rng&& rng) noexcept {
+			if constexpr( needs_byteswap<order, tc::range_value_t<Rng>>() ) {
+				return no_adl::byteswapped_blob_adaptor<Rng>(aggregate_tag, std::forward<Rng>(rng));
+			} else {
+				return tc::range_as_blob(std::forward<Rng>(rng));
+			}
+		}
+	}
+
+	// tc::as_blob in little or big endian byte order: a view of t if it is already in that order, otherwise the swapped bytes.
+	template<typename T, std::enable_if_t<std::is_trivially_copyable<std::remove_reference_t<T>>::value>* = nullptr>
+	[[nodiscard]] auto as_blob_le(T&& t) noexcept {
+		return endian_detail::as_blob<boost::endian::order::little>(std::forward<T>(t));
+	}
+
+	template<typename T, std::enable_if_t<std::is_trivially_copyable<std::remove_reference_t<T>>::value>* = nullptr>
+	[[nodiscard]] auto as_blob_be(T&& t) noexcept {
+		return endian_detail::as_blob<boost::endian::order::big>(std::forward<T>(t));
+	}
+
+	// tc::range_as_blob in little or big endian byte order: a view of rng if it is already in that order, otherwise a generator of the swapped bytes.
+	template<typename Rng, std::enable_if_t<tc::has_ptr_begin<Rng>::value>* = nullptr>
+	[[nodiscard]] auto range_as_blob_le(Rng&& rng) noexcept {
+		return endian_detail::range_as_blob<boost::endian::order::little>(std::forward<Rng>(rng));
+	}
+
+	template<typename Rng, std::enable_if_t<tc::has_ptr_begin<Rng>::value>* = nullptr>
+	[[nodiscard]] auto range_as_blob_be(Rng&& rng) noexcept {
+		return endian_detail::range_as_blob<boost::endian::order::big>(std::forward<Rng>(rng));
+	}
+
+	// inverse of tc::as_blob_le / tc::as_blob_be
+	template<typename Dst>
+	[[nodiscard]] Dst bit_cast_range_le(tc::ptr_range<unsigned char const> src) noexcept {
+		return endian_detail::bit_cast_range<boost::endian::order::little, Dst>(src);
+	}
+
+	template<typename Dst>
+	[[nodiscard]] Dst bit_cast_range_be(tc::ptr_range<unsigned char const> src) noexcept {
+		return endian_detail::bit_cast_range<boost::endian::order::big, Dst>(src);
+	}
+}
@@ -0,0 +1,182 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "range_defines.h"
+#include "noncopyable.h"
+#include "subrange.h"
+#include "for_each.h"
+#include "container_traits.h"
+#include "minmax.h"
+#include "file_failure.h"
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+#ifdef _WIN32
+	#include <io.h>
+#else
+	#include <unistd.h>
+	#include <sys/uio.h>
+#endif
+
+namespace tc {
+	namespace fd_sink_detail {
+		struct byte_span final {
+			unsigned char const* m_pb;
+			std::size_t m_nSize;
+		};
+
+		// Writes all bytes of aspan, retrying on partial writes and interrupts.
+		inline void write_all(int const fd, byte_span* aspan, std::size_t nSpans) THROW(tc::file_failure) {
+#ifdef _WIN32
+			for( ; 0<nSpans; ++aspan, --nSpans ) {
+				while( 0<aspan->m_nSize ) {
+					int const nWritten=::_write(fd, aspan->m_pb, static_cast<unsigned int>(tc::min(aspan->m_nSize, std::size_t(1)<<30)));
+					if( nWritten<0 ) throw tc::file_failure();
+					aspan->m_pb+=nWritten;
+					aspan->m_nSize-=nWritten;
+				}
+			}
+#else
+			iovec aiov[2];
+			_ASSERT( nSpans<=std::extent<decltype(aiov)>::value );
+			for( std::size_t i=0; i<nSpans; ++i ) {
+				aiov[i].iov_base=const_cast<unsigned char*>(aspan[i].m_pb);
+				aiov[i].iov_len=aspan[i].m_nSize;
+			}
+			iovec* piov=aiov;
+			int nIov=static_cast<int>(nSpans);
+			while( 0<nIov ) {
+				ssize_t nWritten=::writev(fd, piov, nIov);
+				if( nWritten<0 ) {
+					if( EINTR==errno ) continue;
+					throw tc::file_failure();
+				}
+				for( ; 0<nIov && piov->iov_len<=static_cast<std::size_t>(nWritten); ++piov, --nIov ) {
+					nWritten-=piov->iov_len;
+				}
+				if( 0<nIov ) {
+					piov->iov_base=static_cast<unsigned char*>(piov->iov_base)+nWritten;
+					piov->iov_len-=nWritten;
+				}
+			}
+#endif
+		}
+	}
+
+	namespace no_adl {
+		// Sink for tc::for_each. Copies refer to the same file sink and its buffer.
+		template<typename FileSink>
+		struct [[nodiscard]] basic_file_appender /*final*/ {
+			using sink_value_type = unsigned char;
+
+			explicit basic_file_appender(FileSink& filesink) noexcept : m_pfilesink(std::addressof(filesink)) {}
+
+			void operator()(unsigned char const b) const& THROW(tc::file_failure) {
+				m_pfilesink->write(b);
+			}
+			void operator()(char ch) const& THROW(tc::file_failure) {
+				(*this)(static_cast<unsigned char>(ch));
+			}
+
+			// single characters, e.g., tc::append(fdsink, tc::as_dec(n), '\n')
+			template<typename Char, std::enable_if_t<std::is_same<Char, char>::value>* = nullptr> // no conversions to char
+			auto chunk(Char const ch) const& THROW(tc::file_failure) {
+				(*this)(ch);
+				return INTEGRAL_CONSTANT(tc::continue_)();
+			}
+
+			// contiguous bytes, e.g., std::string or tc::as_blob
+			template<typename Rng, std::enable_if_t<
+				tc::has_ptr_begin<Rng const&>::value &&
+				1==sizeof(tc::range_value_t<Rng>) &&
+				std::is_trivially_copyable<tc::range_value_t<Rng>>::value
+			>* = nullptr>
+			auto chunk(Rng const& rng) const& THROW(tc::file_failure) {
+				auto const pBegin=tc::ptr_begin(rng);
+				m_pfilesink->write(reinterpret_cast<unsigned char const*>(pBegin), static_cast<std::size_t>(tc::ptr_end(rng)-pBegin));
+				return INTEGRAL_CONSTANT(tc::continue_)();
+			}
+
+		private:
+			FileSink* m_pfilesink;
+		};
+
+		struct fd_sink;
+		using file_appender = basic_file_appender<fd_sink>;
+
+		// Buffered writer to a file descriptor, which it does not close. Write to it by tc::append(fdsink, rng...) or tc::for_each(rng, fdsink.appender()).
+		// Small writes are collected in the buffer. Chunks at least as large as the buffer are written directly together with the buffered bytes.
+		struct fd_sink final : tc::nonmovable {
+			static constexpr std::size_t c_nDefaultBufferSize=64*1024;
+
+			explicit fd_sink(int const fd, std::size_t const nBufferSize=c_nDefaultBufferSize) noexcept
+				: m_fd(fd)
+				, m_ab(new unsigned char[nBufferSize])
+				, m_nBufferSize(nBufferSize)
+				, m_nBuffered(0)
+			{
+				_ASSERT( 0<nBufferSize );
+			}
+
+			~fd_sink() {
+				try {
+					flush();
+				} catch(tc::file_failure const&) {
+					_ASSERTFALSE; // call flush() before destruction to handle errors
+				}
+			}
+
+			file_appender appender() & noexcept {
+				return file_appender(*this);
+			}
+
+			void flush() & THROW(tc::file_failure) {
+				if( 0<m_nBuffered ) {
+					fd_sink_detail::byte_span span{m_ab.get(), m_nBuffered};
+					m_nBuffered=0; // on failure, the buffered bytes are lost, but later writes do not repeat them
+					fd_sink_detail::write_all(m_fd, &span, 1);
+				}
+			}
+
+			void write(unsigned char const b) & THROW(tc::file_failure) {
+				if( m_nBuffered==m_nBufferSize ) flush();
+				m_ab[m_nBuffered++]=b;
+			}
+
+			void write(unsigned char const* const pb, std::size_t const nSize) & THROW(tc::file_failure) {
+				if( nSize<=m_nBufferSize-m_nBuffered ) {
+					std::memcpy(m_ab.get()+m_nBuffered, pb, nSize);
+					m_nBuffered+=nSize;
+				} else if( nSize<m_nBufferSize ) {
+					flush();
+					std::memcpy(m_ab.get(), pb, nSize);
+					m_nBuffered=nSize;
+				} else {
+					// large chunk: skip the copy into the buffer
+					fd_sink_detail::byte_span aspan[]={{m_ab.get(), m_nBuffered}, {pb, nSize}};
+					m_nBuffered=0;
+					fd_sink_detail::write_all(m_fd, aspan, 2);
+				}
+			}
+
+		private:
+			int const m_fd;
+			std::unique_ptr<unsigned char[]> m_ab;
+			std::size_t const m_nBufferSize;
+			std::size_t m_nBuffered;
+		};
+	}
+	using no_adl::basic_file_appender;
+	using no_adl::fd_sink;
+	using no_adl::file_appender;
+}
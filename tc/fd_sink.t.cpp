@@ -0,0 +1,68 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "range.h"
+#include "container.h" // tc::vector
+#include "range.t.h"
+#include "fd_sink.h"
+#include "async_fd_sink.h"
+#include "for_each_xxx.h"
+#include "append.h"
+#include "format.h"
+
+#ifndef _WIN32
+#include <cstdio>
+
+namespace {
+	std::string read_all(std::FILE* pfile) noexcept {
+		std::rewind(pfile);
+		std::string str;
+		char ach[4096];
+		for(;;) {
+			std::size_t const n=std::fread(ach, 1, sizeof(ach), pfile);
+			if( 0==n ) break;
+			tc::append(str, tc::counted(ach, n));
+		}
+		return str;
+	}
+}
+
+UNITTESTDEF( fd_sink_small_and_large_writes ) {
+	std::FILE* const pfile=std::tmpfile();
+	_ASSERT( pfile );
+	std::string const strLarge(100, 'x');
+	{
+		tc::fd_sink fdsink(::fileno(pfile), 16);
+		tc::append(fdsink, "ab", tc::as_dec(123), 'c'); // buffered
+		tc::for_each(strLarge, fdsink.appender()); // larger than the buffer, written directly after the buffered bytes
+		tc::append(fdsink, tc::single('d'));
+		fdsink.flush();
+	}
+	TEST_RANGE_EQUAL( read_all(pfile), tc::concat("ab123c", strLarge, "d") );
+	std::fclose(pfile);
+}
+
+UNITTESTDEF( async_fd_sink_double_buffering ) {
+	std::FILE* const pfile=std::tmpfile();
+	_ASSERT( pfile );
+	auto const rngn=tc::iota(0, 10000);
+	std::string const str="size prefixed";
+	{
+		tc::async_fd_sink fdsink(::fileno(pfile), 64); // many hand-overs between the two buffers
+		tc::for_each(tc::join_separated(tc::transform(rngn, [](int n) noexcept { return tc::as_dec(n); }), ","), fdsink.appender());
+		tc::for_each(tc::size_prefixed(str), fdsink.appender());
+		fdsink.flush();
+	}
+	auto strExpected=tc::make_str(tc::join_separated(tc::transform(rngn, [](int n) noexcept { return tc::as_dec(n); }), ","));
+	auto const nSize=tc::implicit_cast<std::uint32_t>(tc::size(str));
+	strExpected.append(reinterpret_cast<char const*>(&nSize), sizeof(nSize));
+	strExpected+=str;
+	TEST_RANGE_EQUAL( read_all(pfile), strExpected );
+	std::fclose(pfile);
+}
+#endif
@@ -52,6 +52,11 @@ namespace tc {
 				: base_(aggregate_tag, std::forward<RngRef>(rng))
 				, m_pred(std::forward<PredRef>(pred))
 			{}
+
+			template< ENABLE_SFINAE, std::enable_if_t<tc::has_size_upper_bound<SFINAE_TYPE(Rng)>::value>* = nullptr >
+			constexpr std::size_t size_upper_bound() const& MAYTHROW {
+				return tc::size_upper_bound(*this->m_baserng);
+			}
 		};
 
 		template< typename Pred, typename Rng >
@@ -0,0 +1,770 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "range_defines.h"
+#include "range_adaptor.h"
+#include "index_iterator.h"
+#include "container.h"
+#include "insert.h"
+#include "bitfield.h"
+
+#include <boost/endian/conversion.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <tuple>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2<=_M_IX86_FP)
+	#define TC_FLAT_HASH_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace tc {
+	// Open addressing hash table in the style of Abseil's Swiss table: elements are stored inline in one array,
+	// a parallel array of control bytes holds 7 bits of the hash of each element, which are compared for a whole
+	// group of slots at once. Most lookups thus touch one cache line of control bytes and one slot.
+	// Iterators and references are invalidated by rehashing, but not by erase.
+	namespace flat_hash_detail {
+		using ctrl_t = signed char;
+		constexpr ctrl_t c_ctrlEmpty = -128;
+		constexpr ctrl_t c_ctrlDeleted = -2;
+		constexpr ctrl_t c_ctrlSentinel = -1;
+		// full slots hold the 7 low bits of the hash, i.e., a value in [0, 127]
+
+		[[nodiscard]] constexpr bool is_full(ctrl_t ctrl) noexcept {
+			return 0<=ctrl;
+		}
+
+		// Control bytes of tables without allocation. The sentinel stops iteration, the empty bytes stop probing.
+		alignas(16) inline constexpr ctrl_t c_actrlEmptyGroup[16]={
+			c_ctrlSentinel, c_ctrlEmpty, c_ctrlEmpty, c_ctrlEmpty, c_ctrlEmpty, c_ctrlEmpty, c_ctrlEmpty, c_ctrlEmpty,
+			c_ctrlEmpty, c_ctrlEmpty, c_ctrlEmpty, c_ctrlEmpty, c_ctrlEmpty, c_ctrlEmpty, c_ctrlEmpty, c_ctrlEmpty
+		};
+
+		// Set of matching slots in a group, each slot occupying 1<<nShift bits of the mask.
+		template<typename T, int nWidth, int nShift>
+		struct bitmask final {
+			T m_n;
+
+			explicit operator bool() const& noexcept {
+				return 0!=m_n;
+			}
+			int lowest() const& noexcept {
+				return static_cast<int>(tc::index_of_least_significant_bit(m_n))>>nShift;
+			}
+			void pop_lowest() & noexcept {
+				m_n&=m_n-1;
+			}
+			int trailing_zeros() const& noexcept {
+				return m_n ? lowest() : nWidth;
+			}
+			int leading_zeros() const& noexcept {
+				return m_n ? ((nWidth<<nShift)-1-static_cast<int>(tc::index_of_most_significant_bit(m_n)))>>nShift : nWidth;
+			}
+		};
+
+#ifdef TC_FLAT_HASH_SSE2
+		struct group final {
+			static constexpr int c_nWidth=16;
+			using bitmask_type = bitmask<unsigned long, 16, 0>;
+
+			explicit group(ctrl_t const* pctrl) noexcept
+				: m_ctrl(_mm_loadu_si128(reinterpret_cast<__m128i const*>(pctrl)))
+			{}
+
+			bitmask_type match(ctrl_t h2) const& noexcept {
+				return {static_cast<unsigned long>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)))};
+			}
+			bitmask_type match_empty() const& noexcept {
+				return match(c_ctrlEmpty);
+			}
+			bitmask_type match_empty_or_deleted() const& noexcept {
+				// signed comparison: only c_ctrlEmpty and c_ctrlDeleted are less than c_ctrlSentinel
+				return {static_cast<unsigned long>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(c_ctrlSentinel), m_ctrl)))};
+			}
+
+		private:
+			__m128i m_ctrl;
+		};
+#else
+		// Portable fallback treating 8 control bytes as one 64 bit word. The match result is only used as a hint
+		// and may report false positives in the byte after a true match. Elements are compared anyway.
+		struct group final {
+			static constexpr int c_nWidth=8;
+			using bitmask_type = bitmask<std::uint64_t, 8, 3>;
+
+			explicit group(ctrl_t const* pctrl) noexcept {
+				std::memcpy(std::addressof(m_ctrl), pctrl, sizeof(m_ctrl));
+				m_ctrl=boost::endian::little_to_native(m_ctrl);
+			}
+
+			bitmask_type match(ctrl_t h2) const& noexcept {
+				auto const n=m_ctrl ^ (c_nLsbs*static_cast<unsigned char>(h2));
+				return {(n-c_nLsbs) & ~n & c_nMsbs};
+			}
+			bitmask_type match_empty() const& noexcept {
+				return {m_ctrl & (~m_ctrl<<6) & c_nMsbs};
+			}
+			bitmask_type match_empty_or_deleted() const& noexcept {
+				return {m_ctrl & (~m_ctrl<<7) & c_nMsbs};
+			}
+
+		private:
+			static constexpr std::uint64_t c_nLsbs=0x0101010101010101;
+			static constexpr std::uint64_t c_nMsbs=0x8080808080808080;
+			std::uint64_t m_ctrl;
+		};
+#endif
+
+		// Triangular probing over groups visits every group exactly once if the number of groups is a power of 2.
+		struct probe_seq final {
+			probe_seq(std::size_t nHash, std::size_t nMask) noexcept
+				: m_nMask(nMask)
+				, m_nOffset(nHash & nMask)
+				, m_nIndex(0)
+			{}
+
+			std::size_t offset() const& noexcept {
+				return m_nOffset;
+			}
+			std::size_t offset(int i) const& noexcept {
+				return (m_nOffset+i) & m_nMask;
+			}
+			void next() & noexcept {
+				m_nIndex+=group::c_nWidth;
+				m_nOffset=(m_nOffset+m_nIndex) & m_nMask;
+				_ASSERT(m_nIndex<=m_nMask+group::c_nWidth); // table is never full
+			}
+
+		private:
+			std::size_t m_nMask;
+			std::size_t m_nOffset;
+			std::size_t m_nIndex;
+		};
+
+		// Hash functions like std::hash<int> may be the identity, but we need well distributed high and low bits.
+		[[nodiscard]] inline std::uint64_t mix_hash(std::size_t nHash) noexcept {
+			auto const n=static_cast<std::uint64_t>(nHash)*0x9e3779b97f4a7c15;
+			return n ^ (n>>32);
+		}
+		[[nodiscard]] inline std::size_t h1(std::uint64_t nHash) noexcept {
+			return static_cast<std::size_t>(nHash>>7);
+		}
+		[[nodiscard]] inline ctrl_t h2(std::uint64_t nHash) noexcept {
+			return static_cast<ctrl_t>(nHash & 0x7f);
+		}
+
+		// views contiguous ranges of Char, e.g., std::basic_string, string literals or tc::ptr_range<Char const>, without copying them
+		template<typename Char, typename Rng, std::enable_if_t<tc::has_ptr_begin<Rng const&>::value && std::is_same<tc::range_value_t<Rng>, Char>::value>* = nullptr>
+		[[nodiscard]] std::basic_string_view<Char> as_string_view(Rng const& rng) noexcept {
+			auto const pBegin=tc::ptr_begin(rng);
+			return std::basic_string_view<Char>(pBegin, static_cast<std::size_t>(tc::ptr_end(rng)-pBegin));
+		}
+
+		// Default hash and equality for string keys. Both accept any contiguous range of Char, so heterogeneous lookup does not create a std::basic_string.
+		template<typename Char>
+		struct fn_hash_string_view final {
+			template<typename Rng>
+			auto operator()(Rng const& rng) const& return_decltype_noexcept(
+				std::hash<std::basic_string_view<Char>>()(flat_hash_detail::as_string_view<Char>(rng))
+			)
+		};
+
+		template<typename Char>
+		struct fn_equal_string_view final {
+			template<typename Lhs, typename Rhs>
+			auto operator()(Lhs const& lhs, Rhs const& rhs) const& return_decltype_noexcept(
+				flat_hash_detail::as_string_view<Char>(lhs)==flat_hash_detail::as_string_view<Char>(rhs)
+			)
+		};
+
+		// capacities are 2^k-1, the maximum load factor is 7/8
+		[[nodiscard]] constexpr std::size_t capacity_to_growth(std::size_t nCapacity) noexcept {
+			return group::c_nWidth==8 && 7==nCapacity ? 6 : nCapacity-nCapacity/8;
+		}
+		[[nodiscard]] constexpr std::size_t normalize_capacity(std::size_t n) noexcept {
+			std::size_t nCapacity=1;
+			while(nCapacity<n) nCapacity=nCapacity*2+1;
+			return nCapacity;
+		}
+		[[nodiscard]] constexpr std::size_t growth_to_capacity(std::size_t nGrowth) noexcept {
+			return normalize_capacity(group::c_nWidth==8 && 7==nGrowth ? 8 : nGrowth+(nGrowth-1)/7);
+		}
+	}
+
+	namespace no_adl {
+		template<typename Key>
+		struct flat_hash_set_policy final {
+			using key_type = Key;
+			using value_type = Key;
+			using slot_type = Key;
+			static Key const& key(value_type const& key) noexcept { return key; }
+			static Key const& element(value_type const& key) noexcept { return key; } // keys are immutable
+
+			static value_type& value(slot_type& slot) noexcept { return slot; }
+			static value_type const& value(slot_type const& slot) noexcept { return slot; }
+
+			template<typename Alloc, typename... Args>
+			static void construct(Alloc& alloc, slot_type* pslot, Args&&... args) MAYTHROW {
+				std::allocator_traits<Alloc>::construct(alloc, pslot, std::forward<Args>(args)...); // MAYTHROW
+			}
+			template<typename Alloc>
+			static void destroy(Alloc& alloc, slot_type* pslot) noexcept {
+				std::allocator_traits<Alloc>::destroy(alloc, pslot);
+			}
+			// moves the element to uninitialized pslotNew and destroys it at pslotOld
+			template<typename Alloc>
+			static void transfer(Alloc& alloc, slot_type* pslotNew, slot_type* pslotOld) noexcept {
+				NOEXCEPT(construct(alloc, pslotNew, tc_move_always(*pslotOld)));
+				destroy(alloc, pslotOld);
+			}
+		};
+
+		template<typename Key, typename T>
+		struct flat_hash_map_policy final {
+			using key_type = Key;
+			using mapped_type = T;
+			using value_type = std::pair<Key const, T>;
+
+			// Like Abseil, we store a union to move the key when rehashing, which std::pair<Key const, T> would copy.
+			// Elements are constructed and accessed as value_type, only transfer uses the mutable pair.
+			union slot_type {
+				value_type m_value;
+				std::pair<Key, T> m_mutable;
+
+				slot_type() noexcept {}
+				~slot_type() {}
+			};
+
+			static Key const& key(value_type const& pair) noexcept { return pair.first; }
+			static value_type& element(value_type& pair) noexcept { return pair; }
+			static value_type const& element(value_type const& pair) noexcept { return pair; }
+
+			static value_type& value(slot_type& slot) noexcept { return slot.m_value; }
+			static value_type const& value(slot_type const& slot) noexcept { return slot.m_value; }
+
+			template<typename Alloc, typename... Args>
+			static void construct(Alloc& alloc, slot_type* pslot, Args&&... args) MAYTHROW {
+				std::allocator_traits<Alloc>::construct(alloc, std::addressof(pslot->m_value), std::forward<Args>(args)...); // MAYTHROW
+			}
+			template<typename Alloc>
+			static void destroy(Alloc& alloc, slot_type* pslot) noexcept {
+				std::allocator_traits<Alloc>::destroy(alloc, std::addressof(pslot->m_value));
+			}
+			// moves the element to uninitialized pslotNew and destroys it at pslotOld
+			template<typename Alloc>
+			static void transfer(Alloc& alloc, slot_type* pslotNew, slot_type* pslotOld) noexcept {
+				NOEXCEPT(std::allocator_traits<Alloc>::construct(alloc, std::addressof(pslotNew->m_mutable), tc_move_always(pslotOld->m_mutable)));
+				std::allocator_traits<Alloc>::destroy(alloc, std::addressof(pslotOld->m_mutable));
+			}
+		};
+	}
+
+	namespace flat_hash_adl {
+		template<typename Policy, typename Hash, typename KeyEqual, typename Alloc>
+		struct [[nodiscard]] flat_hash_table
+			: tc::range_iterator_generator_from_index<
+				flat_hash_table<Policy, Hash, KeyEqual, Alloc>,
+				std::size_t
+			>
+		{
+		private:
+			using this_type = flat_hash_table;
+			using group = flat_hash_detail::group;
+			using ctrl_t = flat_hash_detail::ctrl_t;
+		public:
+			using index = typename this_type::index;
+			using iterator = typename this_type::iterator;
+			using const_iterator = typename this_type::const_iterator;
+			using key_type = typename Policy::key_type;
+			using value_type = typename Policy::value_type;
+			using size_type = std::size_t;
+			using hasher = Hash;
+			using key_equal = KeyEqual;
+			using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<value_type>;
+
+		private:
+			using slot_type = typename Policy::slot_type;
+			using slot_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<slot_type>;
+			using alloc_traits = std::allocator_traits<slot_allocator_type>;
+			using ctrl_allocator_type = typename alloc_traits::template rebind_alloc<ctrl_t>;
+
+			// Heterogeneous lookup with keys that hash and compare like key_type, e.g., string ranges for std::basic_string keys
+			template<typename K>
+			using is_compatible_key = std::integral_constant<bool,
+				!std::is_same<tc::decay_t<K>, key_type>::value
+				&& tc::is_invocable<Hash const&, K const&>::value
+				&& tc::is_invocable<KeyEqual const&, K const&, key_type const&>::value
+			>;
+
+			ctrl_t* m_pctrl=const_cast<ctrl_t*>(flat_hash_detail::c_actrlEmptyGroup); // never written while capacity is 0
+			slot_type* m_pslot=nullptr;
+			std::size_t m_nSize=0;
+			std::size_t m_nCapacity=0;
+			std::size_t m_nGrowthLeft=0;
+			Hash m_hash;
+			KeyEqual m_keyeq;
+			slot_allocator_type m_alloc;
+
+		public:
+			flat_hash_table() noexcept(std::is_nothrow_default_constructible<Hash>::value && std::is_nothrow_default_constructible<KeyEqual>::value && std::is_nothrow_default_constructible<allocator_type>::value) {}
+
+			explicit flat_hash_table(std::size_t n, Hash const& hash=Hash(), KeyEqual const& keyeq=KeyEqual(), allocator_type const& alloc=allocator_type()) MAYTHROW
+				: m_hash(hash)
+				, m_keyeq(keyeq)
+				, m_alloc(alloc)
+			{
+				reserve(n); // MAYTHROW
+			}
+
+			explicit flat_hash_table(allocator_type const& alloc) noexcept
+				: m_alloc(alloc)
+			{}
+
+			flat_hash_table(flat_hash_table const& other) MAYTHROW
+				: m_hash(other.m_hash)
+				, m_keyeq(other.m_keyeq)
+				, m_alloc(alloc_traits::select_on_container_copy_construction(other.m_alloc))
+			{
+				try {
+					reserve(other.size()); // MAYTHROW
+					other.for_each_full_slot([&](std::size_t idx) MAYTHROW {
+						construct_unique(Policy::key(other.slot_value(idx)), other.slot_value(idx)); // MAYTHROW
+					});
+				} catch(...) {
+					// the destructor does not run if the constructor throws
+					destroy_and_deallocate();
+					throw;
+				}
+			}
+
+			flat_hash_table(flat_hash_table&& other) noexcept
+				: m_hash(tc_move(other.m_hash))
+				, m_keyeq(tc_move(other.m_keyeq))
+				, m_alloc(tc_move(other.m_alloc))
+			{
+				steal(other);
+			}
+
+			flat_hash_table& operator=(flat_hash_table const& other) & MAYTHROW {
+				if( std::addressof(other)!=this ) {
+					*this=flat_hash_table(other); // MAYTHROW
+				}
+				return *this;
+			}
+
+			flat_hash_table& operator=(flat_hash_table&& other) & MAYTHROW {
+				_ASSERT( std::addressof(other)!=this ); // self assignment from rvalues should not happen, rvalues must be expiring
+				m_hash=tc_move(other.m_hash);
+				m_keyeq=tc_move(other.m_keyeq);
+				if constexpr( alloc_traits::propagate_on_container_move_assignment::value ) {
+					destroy_and_deallocate();
+					m_alloc=tc_move(other.m_alloc);
+					steal(other);
+				} else if( m_alloc==other.m_alloc ) {
+					destroy_and_deallocate();
+					steal(other);
+				} else {
+					// memory of other cannot be taken over, move elements one by one
+					clear();
+					reserve(other.size()); // MAYTHROW
+					other.for_each_full_slot([&](std::size_t idx) MAYTHROW {
+						construct_unique(Policy::key(other.slot_value(idx)), tc_move_always(other.slot_value(idx))); // MAYTHROW
+					});
+					other.clear();
+				}
+				return *this;
+			}
+
+			~flat_hash_table() {
+				destroy_and_deallocate();
+			}
+
+		private:
+			STATIC_FINAL(begin_index)() const& noexcept -> index {
+				return skip_empty_or_deleted(0);
+			}
+			STATIC_FINAL(end_index)() const& noexcept -> index {
+				return m_nCapacity; // position of the sentinel
+			}
+			STATIC_FINAL(equal_index)(index const& idxLhs, index const& idxRhs) const& noexcept -> bool {
+				return idxLhs==idxRhs;
+			}
+			STATIC_FINAL(increment_index)(index& idx) const& noexcept -> void {
+				_ASSERT(idx<m_nCapacity);
+				idx=skip_empty_or_deleted(idx+1);
+			}
+			STATIC_FINAL(dereference_index)(index const& idx) & noexcept -> decltype(auto) {
+				_ASSERT(flat_hash_detail::is_full(m_pctrl[idx]));
+				return Policy::element(slot_value(idx));
+			}
+			STATIC_FINAL(dereference_index)(index const& idx) const& noexcept -> decltype(auto) {
+				_ASSERT(flat_hash_detail::is_full(m_pctrl[idx]));
+				return Policy::element(slot_value(idx));
+			}
+
+		public:
+			// query state
+			bool empty() const& noexcept {
+				return 0==m_nSize;
+			}
+			size_type size() const& noexcept {
+				return m_nSize;
+			}
+			// number of elements the table can hold without rehashing
+			size_type capacity() const& noexcept {
+				return m_nSize+m_nGrowthLeft;
+			}
+			hasher hash_function() const& noexcept {
+				return m_hash;
+			}
+			key_equal key_eq() const& noexcept {
+				return m_keyeq;
+			}
+			allocator_type get_allocator() const& noexcept {
+				return allocator_type(m_alloc);
+			}
+
+			// lookup
+			const_iterator find(key_type const& key) const& noexcept {
+				return this->make_iterator(find_index(key));
+			}
+			iterator find(key_type const& key) & noexcept {
+				return this->make_iterator(find_index(key));
+			}
+			template<typename K, std::enable_if_t<is_compatible_key<K>::value>* = nullptr>
+			const_iterator find(K const& key) const& noexcept {
+				return this->make_iterator(find_index(key));
+			}
+			template<typename K, std::enable_if_t<is_compatible_key<K>::value>* = nullptr>
+			iterator find(K const& key) & noexcept {
+				return this->make_iterator(find_index(key));
+			}
+
+			bool contains(key_type const& key) const& noexcept {
+				return m_nCapacity!=find_index(key);
+			}
+			template<typename K, std::enable_if_t<is_compatible_key<K>::value>* = nullptr>
+			bool contains(K const& key) const& noexcept {
+				return m_nCapacity!=find_index(key);
+			}
+
+			size_type count(key_type const& key) const& noexcept {
+				return contains(key) ? 1 : 0;
+			}
+			template<typename K, std::enable_if_t<is_compatible_key<K>::value>* = nullptr>
+			size_type count(K const& key) const& noexcept {
+				return contains(key) ? 1 : 0;
+			}
+
+			// modify
+			std::pair<iterator, bool> insert(value_type const& v) & MAYTHROW {
+				return emplace_unique(Policy::key(v), v);
+			}
+			std::pair<iterator, bool> insert(value_type&& v) & MAYTHROW {
+				return emplace_unique(Policy::key(v), tc_move(v));
+			}
+
+			template<typename... Args>
+			std::pair<iterator, bool> emplace(Args&&... args) & MAYTHROW {
+				if constexpr( 1==sizeof...(Args) && (std::is_same<tc::decay_t<Args>, value_type>::value && ...) ) {
+					return insert(std::forward<Args>(args)...);
+				} else {
+					// key must be known before the slot is chosen
+					return insert(value_type(std::forward<Args>(args)...)); // MAYTHROW
+				}
+			}
+
+			// std::unordered_map::try_emplace, additionally accepting compatible keys which are converted to key_type only on insertion
+			template<typename K, typename... Args, typename Policy_=Policy, typename=typename Policy_::mapped_type>
+			std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) & MAYTHROW {
+				return emplace_unique(key, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+			}
+
+			template<typename K, typename Policy_=Policy>
+			typename Policy_::mapped_type& operator[](K&& key) & MAYTHROW {
+				return try_emplace(std::forward<K>(key)).first->second;
+			}
+
+			iterator erase(const_iterator it) & noexcept {
+				auto idx=tc::iterator2index(it);
+				erase_index(idx);
+				this->increment_index(idx);
+				return this->make_iterator(idx);
+			}
+
+			// range_filter relies on erase not invalidating iterators to other elements
+			iterator erase(const_iterator itBegin, const_iterator itEnd) & noexcept {
+				auto const idxEnd=tc::iterator2index(itEnd);
+				for( auto idx=tc::iterator2index(itBegin); idx!=idxEnd; this->increment_index(idx) ) {
+					erase_index(idx);
+				}
+				return this->make_iterator(idxEnd);
+			}
+
+			size_type erase(key_type const& key) & noexcept {
+				return erase_key(key);
+			}
+			template<typename K, std::enable_if_t<is_compatible_key<K>::value>* = nullptr>
+			size_type erase(K const& key) & noexcept {
+				return erase_key(key);
+			}
+
+			void clear() & noexcept {
+				if( 0!=m_nSize ) {
+					NOEXCEPT(for_each_full_slot([&](std::size_t idx) noexcept {
+						Policy::destroy(m_alloc, m_pslot+idx);
+					}));
+					reset_ctrl();
+					m_nSize=0;
+				}
+				m_nGrowthLeft=flat_hash_detail::capacity_to_growth(m_nCapacity);
+			}
+
+			void reserve(size_type n) & MAYTHROW {
+				if( capacity()<n ) {
+					resize(flat_hash_detail::growth_to_capacity(n)); // MAYTHROW
+				}
+			}
+
+		private:
+			value_type& slot_value(index idx) & noexcept {
+				return Policy::value(m_pslot[idx]);
+			}
+			value_type const& slot_value(index idx) const& noexcept {
+				return Policy::value(m_pslot[idx]);
+			}
+
+			template<typename Func>
+			void for_each_full_slot(Func func) const& MAYTHROW {
+				for( std::size_t idx=0; idx!=m_nCapacity; ++idx ) {
+					if( flat_hash_detail::is_full(m_pctrl[idx]) ) func(idx); // MAYTHROW
+				}
+			}
+
+			index skip_empty_or_deleted(index idx) const& noexcept {
+				while( m_pctrl[idx]<flat_hash_detail::c_ctrlSentinel ) ++idx; // the sentinel ends the loop
+				return idx;
+			}
+
+			template<typename K>
+			std::uint64_t hash(K const& key) const& noexcept {
+				return flat_hash_detail::mix_hash(m_hash(key));
+			}
+
+			// returns m_nCapacity if not found
+			template<typename K>
+			index find_index(K const& key, std::uint64_t nHash) const& noexcept {
+				flat_hash_detail::probe_seq seq(flat_hash_detail::h1(nHash), m_nCapacity);
+				for(;;) {
+					group const grp(m_pctrl+seq.offset());
+					for( auto mask=grp.match(flat_hash_detail::h2(nHash)); mask; mask.pop_lowest() ) {
+						auto const idx=seq.offset(mask.lowest());
+						if( m_keyeq(key, Policy::key(slot_value(idx))) ) return idx;
+					}
+					if( grp.match_empty() ) return m_nCapacity;
+					seq.next();
+				}
+			}
+
+			template<typename K>
+			index find_index(K const& key) const& noexcept {
+				return find_index(key, hash(key));
+			}
+
+			index find_first_non_full(std::uint64_t nHash) const& noexcept {
+				flat_hash_detail::probe_seq seq(flat_hash_detail::h1(nHash), m_nCapacity);
+				for(;;) {
+					if( auto const mask=group(m_pctrl+seq.offset()).match_empty_or_deleted() ) {
+						return seq.offset(mask.lowest());
+					}
+					seq.next();
+				}
+			}
+
+			template<typename K, typename... Args>
+			std::pair<iterator, bool> emplace_unique(K const& key, Args&&... args) & MAYTHROW {
+				auto const nHash=hash(key);
+				if( auto const idx=find_index(key, nHash); m_nCapacity!=idx ) {
+					return std::make_pair(this->make_iterator(idx), false);
+				}
+				return std::make_pair(this->make_iterator(construct_at_new_slot(nHash, std::forward<Args>(args)...)), true); // MAYTHROW
+			}
+
+			// key is known to be absent
+			template<typename K, typename... Args>
+			void construct_unique(K const& key, Args&&... args) & MAYTHROW {
+				construct_at_new_slot(hash(key), std::forward<Args>(args)...); // MAYTHROW
+			}
+
+			template<typename... Args>
+			index construct_at_new_slot(std::uint64_t nHash, Args&&... args) & MAYTHROW {
+				auto idx=find_first_non_full(nHash);
+				if( 0==m_nGrowthLeft && flat_hash_detail::c_ctrlDeleted!=m_pctrl[idx] ) {
+					rehash_and_grow(); // MAYTHROW
+					idx=find_first_non_full(nHash);
+				}
+				NOBADALLOC(Policy::construct(m_alloc, m_pslot+idx, std::forward<Args>(args)...)); // MAYTHROW
+				// mark slot as full only after successful construction
+				if( flat_hash_detail::c_ctrlEmpty==m_pctrl[idx] ) --m_nGrowthLeft;
+				set_ctrl(idx, flat_hash_detail::h2(nHash));
+				++m_nSize;
+				return idx;
+			}
+
+			template<typename K>
+			size_type erase_key(K const& key) & noexcept {
+				if( auto const idx=find_index(key); m_nCapacity!=idx ) {
+					erase_index(idx);
+					return 1;
+				} else {
+					return 0;
+				}
+			}
+
+			void erase_index(index idx) & noexcept {
+				_ASSERT(flat_hash_detail::is_full(m_pctrl[idx]));
+				Policy::destroy(m_alloc, m_pslot+idx);
+				--m_nSize;
+				// If the slot was never part of a full group, no probe sequence can have continued past it, and it can become empty again.
+				auto const idxBefore=(idx-group::c_nWidth) & m_nCapacity;
+				auto const maskEmptyAfter=group(m_pctrl+idx).match_empty();
+				auto const maskEmptyBefore=group(m_pctrl+idxBefore).match_empty();
+				if( maskEmptyBefore && maskEmptyAfter && maskEmptyAfter.trailing_zeros()+maskEmptyBefore.leading_zeros()<group::c_nWidth ) {
+					set_ctrl(idx, flat_hash_detail::c_ctrlEmpty);
+					++m_nGrowthLeft;
+				} else {
+					set_ctrl(idx, flat_hash_detail::c_ctrlDeleted);
+				}
+			}
+
+			// The first group::c_nWidth-1 control bytes are cloned after the sentinel, so that groups can be loaded at any position without wrapping around.
+			void set_ctrl(index idx, ctrl_t ctrl) & noexcept {
+				_ASSERT(idx<m_nCapacity);
+				m_pctrl[idx]=ctrl;
+				m_pctrl[((idx-(group::c_nWidth-1)) & m_nCapacity)+((group::c_nWidth-1) & m_nCapacity)]=ctrl;
+			}
+
+			void reset_ctrl() & noexcept {
+				std::memset(m_pctrl, static_cast<unsigned char>(flat_hash_detail::c_ctrlEmpty), m_nCapacity+group::c_nWidth);
+				m_pctrl[m_nCapacity]=flat_hash_detail::c_ctrlSentinel;
+			}
+
+			void rehash_and_grow() & MAYTHROW {
+				if( 0==m_nCapacity ) {
+					resize(1); // MAYTHROW
+				} else if( group::c_nWidth<m_nCapacity && static_cast<std::uint64_t>(m_nSize)*32<=static_cast<std::uint64_t>(m_nCapacity)*25 ) {
+					resize(m_nCapacity); // MAYTHROW, mostly tombstones: rehash at same capacity to get rid of them
+				} else {
+					resize(m_nCapacity*2+1); // MAYTHROW
+				}
+			}
+
+			void resize(std::size_t nCapacity) & MAYTHROW {
+				_ASSERT(0==(nCapacity & (nCapacity+1)));
+				ctrl_allocator_type allocctrl(m_alloc);
+				auto* const pctrl=std::allocator_traits<ctrl_allocator_type>::allocate(allocctrl, nCapacity+group::c_nWidth); // MAYTHROW
+				slot_type* pslot;
+				try {
+					pslot=alloc_traits::allocate(m_alloc, nCapacity); // MAYTHROW
+				} catch(...) {
+					std::allocator_traits<ctrl_allocator_type>::deallocate(allocctrl, pctrl, nCapacity+group::c_nWidth);
+					throw;
+				}
+
+				auto* const pctrlOld=m_pctrl;
+				auto* const pslotOld=m_pslot;
+				auto const nCapacityOld=m_nCapacity;
+				m_pctrl=pctrl;
+				m_pslot=pslot;
+				m_nCapacity=nCapacity;
+				reset_ctrl();
+				m_nGrowthLeft=flat_hash_detail::capacity_to_growth(nCapacity)-m_nSize;
+
+				for( std::size_t idxOld=0; idxOld!=nCapacityOld; ++idxOld ) {
+					if( flat_hash_detail::is_full(pctrlOld[idxOld]) ) {
+						auto const nHash=hash(Policy::key(Policy::value(pslotOld[idxOld])));
+						auto const idx=find_first_non_full(nHash);
+						set_ctrl(idx, flat_hash_detail::h2(nHash));
+						Policy::transfer(m_alloc, m_pslot+idx, pslotOld+idxOld); // key and value are moved
+					}
+				}
+				deallocate(pctrlOld, pslotOld, nCapacityOld);
+			}
+
+			void deallocate(ctrl_t* pctrl, slot_type* pslot, std::size_t nCapacity) & noexcept {
+				if( 0!=nCapacity ) {
+					ctrl_allocator_type allocctrl(m_alloc);
+					std::allocator_traits<ctrl_allocator_type>::deallocate(allocctrl, pctrl, nCapacity+group::c_nWidth);
+					alloc_traits::deallocate(m_alloc, pslot, nCapacity);
+				}
+			}
+
+			void destroy_and_deallocate() & noexcept {
+				clear();
+				deallocate(m_pctrl, m_pslot, m_nCapacity);
+				m_pctrl=const_cast<ctrl_t*>(flat_hash_detail::c_actrlEmptyGroup);
+				m_pslot=nullptr;
+				m_nCapacity=0;
+				m_nGrowthLeft=0;
+			}
+
+			void steal(flat_hash_table& other) & noexcept {
+				m_pctrl=std::exchange(other.m_pctrl, const_cast<ctrl_t*>(flat_hash_detail::c_actrlEmptyGroup));
+				m_pslot=std::exchange(other.m_pslot, nullptr);
+				m_nSize=std::exchange(other.m_nSize, 0);
+				m_nCapacity=std::exchange(other.m_nCapacity, 0);
+				m_nGrowthLeft=std::exchange(other.m_nGrowthLeft, 0);
+			}
+		};
+	}
+
+	template<typename Key, typename Hash, typename KeyEqual, typename Alloc>
+	using flat_hash_set_t=flat_hash_adl::flat_hash_table<no_adl::flat_hash_set_policy<Key>, Hash, KeyEqual, Alloc>;
+
+	template<typename Key, typename T, typename Hash, typename KeyEqual, typename Alloc>
+	using flat_hash_map_t=flat_hash_adl::flat_hash_table<no_adl::flat_hash_map_policy<Key, T>, Hash, KeyEqual, Alloc>;
+
+#ifdef TC_PRIVATE
+	template<typename Key, typename Hash=tc::fn_hash<std::size_t, Key>, typename KeyEqual=tc::fn_equal_to, typename Alloc=std::allocator<Key>>
+	using flat_hash_set=flat_hash_set_t<Key, Hash, KeyEqual, Alloc>;
+
+	template<typename Key, typename T, typename Hash=tc::fn_hash<std::size_t, Key>, typename KeyEqual=tc::fn_equal_to, typename Alloc=std::allocator<std::pair<const Key, T>>>
+	using flat_hash_map=flat_hash_map_t<Key, T, Hash, KeyEqual, Alloc>;
+
+	// fn_hash_range hashes any range of Char like the string itself, so string ranges can be looked up without creating a string
+	template<typename Char, typename Hash=tc::fn_hash_range<std::size_t, Char>, typename KeyEqual=decltype(tc::equalfrom3way(tc::fn_lexicographical_compare_3way())), typename Alloc=std::allocator<std::basic_string<Char>>>
+	using flat_hash_set_string=flat_hash_set_t<std::basic_string<Char>, Hash, KeyEqual, Alloc>;
+
+	template<typename Char, typename T, typename Hash=tc::fn_hash_range<std::size_t, Char>, typename KeyEqual=decltype(tc::equalfrom3way(tc::fn_lexicographical_compare_3way())), typename Alloc=std::allocator<std::pair<const std::basic_string<Char>, T>>>
+	using flat_hash_map_string=flat_hash_map_t<std::basic_string<Char>, T, Hash, KeyEqual, Alloc>;
+#else
+	template<typename Key, typename Hash=std::hash<Key>, typename KeyEqual=tc::fn_equal_to, typename Alloc=std::allocator<Key>>
+	using flat_hash_set=flat_hash_set_t<Key, Hash, KeyEqual, Alloc>;
+
+	template<typename Key, typename T, typename Hash=std::hash<Key>, typename KeyEqual=tc::fn_equal_to, typename Alloc=std::allocator<std::pair<const Key, T>>>
+	using flat_hash_map=flat_hash_map_t<Key, T, Hash, KeyEqual, Alloc>;
+
+	template<typename Char, typename Hash=flat_hash_detail::fn_hash_string_view<Char>, typename KeyEqual=flat_hash_detail::fn_equal_string_view<Char>, typename Alloc=std::allocator<std::basic_string<Char>>>
+	using flat_hash_set_string=flat_hash_set_t<std::basic_string<Char>, Hash, KeyEqual, Alloc>;
+
+	template<typename Char, typename T, typename Hash=flat_hash_detail::fn_hash_string_view<Char>, typename KeyEqual=flat_hash_detail::fn_equal_string_view<Char>, typename Alloc=std::allocator<std::pair<const std::basic_string<Char>, T>>>
+	using flat_hash_map_string=flat_hash_map_t<std::basic_string<Char>, T, Hash, KeyEqual, Alloc>;
+#endif
+
+	// like std::map::try_emplace, the key_type object is only constructed if the key is absent
+	template<typename Key, typename Val, typename Hash, typename KeyEqual, typename Alloc, typename K, typename... Args>
+	auto map_try_emplace(tc::flat_hash_map_t<Key, Val, Hash, KeyEqual, Alloc>& map, K&& key, Args&&... args) noexcept {
+		return NOEXCEPT( map.try_emplace(std::forward<K>(key), std::forward<Args>(args)...) );
+	}
+
+}
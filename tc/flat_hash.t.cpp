@@ -0,0 +1,149 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "range.h"
+#include "container.h" // tc::vector
+#include "range.t.h"
+#include "flat_hash.h"
+#include "algorithm.h"
+#include "format.h"
+
+UNITTESTDEF( flat_hash_set_insert_find_erase ) {
+	tc::flat_hash_set<int> setn;
+	_ASSERT( tc::empty(setn) );
+	_ASSERT( setn.end()==setn.find(0) );
+
+	for( int i=0; i<1000; ++i ) {
+		VERIFY( setn.insert(i*7).second );
+	}
+	TEST_EQUAL( setn.size(), 1000u );
+	VERIFY( !setn.insert(7).second );
+	VERIFY( !tc::cont_try_emplace(setn, 14).second );
+	tc::cont_must_insert(setn, -1);
+	TEST_EQUAL( setn.size(), 1001u );
+
+	for( int i=0; i<1000; ++i ) {
+		_ASSERT( setn.contains(i*7) );
+		_ASSERTEQUAL( *setn.find(i*7), i*7 );
+		_ASSERT( !setn.contains(i*7+1) );
+	}
+
+	// erase every other element, lookups must still find the rest behind the tombstones
+	for( int i=0; i<1000; i+=2 ) {
+		TEST_EQUAL( setn.erase(i*7), 1u );
+	}
+	TEST_EQUAL( setn.erase(0), 0u );
+	TEST_EQUAL( setn.size(), 501u );
+	for( int i=0; i<1000; ++i ) {
+		_ASSERTEQUAL( setn.contains(i*7), 1==i%2 );
+	}
+
+	int nSum=0;
+	int nCount=0;
+	tc::for_each(setn, [&](int n) noexcept { nSum+=n; ++nCount; });
+	TEST_EQUAL( nCount, 501 );
+	TEST_EQUAL( nSum, 7*500*500-1 );
+
+	auto vecn=tc::make_vector(setn);
+	tc::sort_inplace(vecn);
+	TEST_EQUAL( tc_front(vecn), -1 );
+	TEST_EQUAL( tc_back(vecn), 999*7 );
+}
+
+UNITTESTDEF( flat_hash_set_range_filter ) {
+	tc::flat_hash_set<int> setn;
+	setn.reserve(100);
+	_ASSERT( 100<=setn.capacity() );
+	for( int i=0; i<100; ++i ) {
+		tc::cont_must_insert(setn, i);
+	}
+	tc::filter_inplace(setn, [](int n) noexcept { return 0==n%3; });
+	TEST_EQUAL( setn.size(), 34u );
+	for( int i=0; i<100; ++i ) {
+		_ASSERTEQUAL( setn.contains(i), 0==i%3 );
+	}
+
+	tc::flat_hash_set<int> setnCopy=setn;
+	setn.clear();
+	_ASSERT( tc::empty(setn) );
+	TEST_EQUAL( setnCopy.size(), 34u );
+	_ASSERT( setnCopy.contains(99) );
+
+	tc::flat_hash_set<int> setnMoved=tc_move(setnCopy);
+	TEST_EQUAL( setnMoved.size(), 34u );
+	_ASSERT( setnMoved.contains(99) );
+}
+
+UNITTESTDEF( flat_hash_map_try_emplace ) {
+	tc::flat_hash_map<std::string, int> mapstrn;
+	VERIFY( tc::map_try_emplace(mapstrn, "a", 1).second );
+	VERIFY( !tc::map_try_emplace(mapstrn, "a", 2).second );
+	VERIFY( tc::map_try_emplace(mapstrn, std::string("b"), 3).second );
+	mapstrn["c"]+=4;
+	mapstrn["c"]+=5;
+	TEST_EQUAL( mapstrn.size(), 3u );
+	TEST_EQUAL( mapstrn.find(std::string("a"))->second, 1 );
+	TEST_EQUAL( mapstrn.find(std::string("b"))->second, 3 );
+	TEST_EQUAL( mapstrn.find(std::string("c"))->second, 9 );
+
+	// heterogeneous lookup
+	_ASSERT( mapstrn.contains("a") );
+	_ASSERT( !mapstrn.contains("d") );
+
+	for( int i=0; i<200; ++i ) {
+		tc::cont_must_emplace(mapstrn, tc::make_str(tc::as_dec(i), "x"), i);
+	}
+	TEST_EQUAL( mapstrn.size(), 203u );
+	TEST_EQUAL( mapstrn.find(std::string("123x"))->second, 123 );
+
+	mapstrn.erase(mapstrn.find(std::string("123x")));
+	_ASSERT( !mapstrn.contains(std::string("123x")) );
+	TEST_EQUAL( mapstrn.size(), 202u );
+}
+
+UNITTESTDEF( flat_hash_set_string_lookup ) {
+	tc::flat_hash_set_string<char> setstr;
+	tc::cont_must_emplace(setstr, "abc");
+	tc::cont_must_emplace(setstr, "de");
+	_ASSERT( setstr.contains("abc") );
+	_ASSERT( !setstr.contains("ab") );
+	std::string const str="xdey";
+	_ASSERT( setstr.contains(tc::make_iterator_range(str.data()+1, str.data()+3)) ); // no std::string is created
+	_ASSERT( setstr.end()!=setstr.find(std::string_view("de")) );
+}
+
+namespace {
+	int g_nLiveCopyThrower=0;
+
+	struct copy_thrower final {
+		int m_n;
+		explicit copy_thrower(int n) noexcept : m_n(n) { ++g_nLiveCopyThrower; }
+		copy_thrower(copy_thrower&& other) noexcept : m_n(other.m_n) { ++g_nLiveCopyThrower; }
+		copy_thrower(copy_thrower const& other) MAYTHROW : m_n(other.m_n) {
+			if( 5==m_n ) throw std::runtime_error("copy_thrower");
+			++g_nLiveCopyThrower;
+		}
+		~copy_thrower() { --g_nLiveCopyThrower; }
+	};
+}
+
+UNITTESTDEF( flat_hash_map_copy_throws ) {
+	{
+		tc::flat_hash_map<int, copy_thrower> mapnthrower;
+		for( int i=0; i<10; ++i ) {
+			tc::cont_must_emplace(mapnthrower, i, copy_thrower(i)); // rehashes move the elements
+		}
+		TEST_EQUAL( g_nLiveCopyThrower, 10 );
+		try {
+			tc::flat_hash_map<int, copy_thrower> mapnthrowerCopy(mapnthrower);
+			_ASSERTFALSE;
+		} catch(std::runtime_error const&) {}
+		TEST_EQUAL( g_nLiveCopyThrower, 10 ); // partial copy was destroyed
+	}
+	TEST_EQUAL( g_nLiveCopyThrower, 0 );
+}
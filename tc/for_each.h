@@ -41,8 +41,9 @@ namespace tc {
 			using type = char;
 		};
 
+		// Binary sinks, e.g., tc::file_appender, get char from formatters like tc::as_dec.
 		template<typename Sink>
-		struct sink_value_or_char<Sink, tc::void_t<tc::sink_value_t<Sink>>> final {
+		struct sink_value_or_char<Sink, std::enable_if_t<tc::is_char<tc::sink_value_t<Sink>>::value>> final {
 			using type = tc::sink_value_t<Sink>;
 		};
 	}
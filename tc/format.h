@@ -16,6 +16,14 @@
 #include "minmax.h"
 #include "concat_adaptor.h"
 #include "repeat_n.h"
+#include "array.h"
+
+#include <array>
+#include <climits>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace tc {
 	///////////////
@@ -45,6 +53,10 @@ namespace tc {
 				return tc::base_cast< integral_as_padded_dec_impl<T,N-1> >(*this)(tc_move(sink));
 			}
 
+			constexpr std::size_t size() const& noexcept {
+				return tc::max(N, integral_as_padded_dec_impl<T,N-1>::size());
+			}
+
 			constexpr bool empty() const& noexcept { return false; }
 		};
 
@@ -59,6 +71,21 @@ namespace tc {
 				return tc::for_each(tc::ptr_begin( boost::lexical_cast< std::array<tc::sink_value_or_char_t<Sink>,50> >(m_n+0/*force integral promotion, otherwise unsigned/signed char gets printed as character*/) ), std::forward<Sink>(sink));
 			}
 
+			// number of characters, without formatting
+			constexpr std::size_t size() const& noexcept {
+				auto const n=m_n+0;
+				auto nAbs=static_cast<std::make_unsigned_t<decltype(n)>>(n);
+				std::size_t nSize=1;
+				if constexpr( std::is_signed<decltype(n)>::value ) {
+					if( n<0 ) {
+						nAbs=0-nAbs;
+						++nSize;
+					}
+				}
+				for( ; 10<=nAbs; nAbs/=10 ) ++nSize;
+				return nSize;
+			}
+
 			constexpr bool empty() const& noexcept { return false; }
 		};
 	}
@@ -113,6 +140,15 @@ namespace tc {
 				// TODO: if continue_if_not_break above returns INTEGRAL_CONSTANT(tc::break_), must exclude this from compilation:
 				return INTEGRAL_CONSTANT(tc::continue_)();
 			}
+
+			// number of characters, without formatting
+			std::size_t size() const& noexcept {
+				auto nShift=sizeof(m_n)*CHAR_BIT;
+				do {
+					nShift-=4;
+				} while( nWidth*4<=nShift && 0==(m_n>>nShift) );
+				return nShift/4+1;
+			}
 		};
 	}
 	using no_adl::as_hex_impl;
@@ -155,6 +191,222 @@ namespace tc {
 		(t)
 	)
 
+	//////////////////////////////////////////////////
+	// compile-time format strings
+	//
+	// tc_format("{} items at {:x}")(n, addr) is the generator range tc::concat(tc::as_dec(n), " items at ", tc::as_unpadded_lc_hex(addr)).
+	// The format string is parsed at compile time. The result has tc::size if all arguments have.
+	// Placeholders are {} and {:[0width][d|x|X]}. Integers are formatted as decimal or hex, characters and ranges, e.g., strings, are inserted as they are.
+	// Padding with width is only supported for non-negative integers. Braces are escaped as {{ and }}.
+	// tc::format_max_size, or max_size() on the result of tc_format, bound the length for integer and character arguments at compile time.
+
+	namespace format_detail {
+		struct format_segment final {
+			std::size_t m_nBegin; // literal text [m_nBegin, m_nEnd)
+			std::size_t m_nEnd;
+			bool m_bArgument;
+			std::size_t m_nArgument;
+			char m_chType; // 'd', 'x' or 'X'
+			std::size_t m_nWidth; // 0 if not padded
+		};
+
+		inline void invalid_format_string() noexcept {
+			_ASSERTFALSE; // not constexpr, i.e., a compile error if reached during constant evaluation
+		}
+
+		// Returns the number of segments. Stores them in pseg unless nullptr.
+		constexpr std::size_t parse_format(char const* const str, format_segment* const pseg) noexcept {
+			std::size_t nSegments=0;
+			std::size_t nArguments=0;
+			auto const emit=[&](format_segment const& seg) noexcept {
+				if( pseg ) pseg[nSegments]=seg;
+				++nSegments;
+			};
+			auto const emit_literal=[&](std::size_t const nBegin, std::size_t const nEnd) noexcept {
+				if( nBegin!=nEnd ) emit(format_segment{nBegin, nEnd, false, 0, 0, 0});
+			};
+
+			std::size_t nLiteral=0;
+			std::size_t i=0;
+			while( '\0'!=str[i] ) {
+				if( '{'==str[i] && '{'==str[i+1] ) {
+					emit_literal(nLiteral, i+1);
+					i+=2;
+					nLiteral=i;
+				} else if( '}'==str[i] ) {
+					if( '}'!=str[i+1] ) invalid_format_string();
+					emit_literal(nLiteral, i+1);
+					i+=2;
+					nLiteral=i;
+				} else if( '{'==str[i] ) {
+					emit_literal(nLiteral, i);
+					++i;
+					char chType='d';
+					std::size_t nWidth=0;
+					if( ':'==str[i] ) {
+						++i;
+						if( '0'==str[i] ) {
+							++i;
+							if( str[i]<'1' || '9'<str[i] ) invalid_format_string();
+							for( ; '0'<=str[i] && str[i]<='9'; ++i ) {
+								nWidth=nWidth*10+static_cast<std::size_t>(str[i]-'0');
+							}
+						}
+						if( 'd'==str[i] || 'x'==str[i] || 'X'==str[i] ) {
+							chType=str[i];
+							++i;
+						}
+					}
+					if( '}'!=str[i] ) invalid_format_string();
+					++i;
+					emit(format_segment{0, 0, true, nArguments, chType, nWidth});
+					++nArguments;
+					nLiteral=i;
+				} else {
+					++i;
+				}
+			}
+			emit_literal(nLiteral, i);
+			return nSegments;
+		}
+
+		template<typename Str>
+		struct parsed_format final {
+			static constexpr std::size_t c_nSegments=parse_format(Str::get(), nullptr);
+			static constexpr std::array<format_segment, c_nSegments> c_aseg=[]() noexcept {
+				std::array<format_segment, c_nSegments> aseg{};
+				parse_format(Str::get(), aseg.data());
+				return aseg;
+			}();
+			static constexpr std::size_t c_nArguments=[]() noexcept {
+				std::size_t n=0;
+				for( auto const& seg : c_aseg ) {
+					if( seg.m_bArgument ) ++n;
+				}
+				return n;
+			}();
+		};
+
+		template<char c_chType, std::size_t c_nWidth, typename T>
+		constexpr decltype(auto) format_argument(T&& t) noexcept {
+			using value_type = tc::decay_t<T>;
+			if constexpr( 'd'!=c_chType ) {
+				static_assert( tc::is_actual_integer<value_type>::value, "hex format requires an integer" );
+				return as_hex_impl<value_type, 0==c_nWidth ? 1 : c_nWidth, 'x'==c_chType ? 'a' : 'A'>(t);
+			} else if constexpr( tc::is_actual_integer<value_type>::value ) {
+				if constexpr( 0==c_nWidth ) {
+					return tc::as_dec(t);
+				} else {
+					return tc::as_padded_dec<c_nWidth>(t);
+				}
+			} else if constexpr( tc::is_char<value_type>::value ) {
+				static_assert( 0==c_nWidth, "width requires an integer" );
+				return tc::single(static_cast<value_type>(t));
+			} else {
+				static_assert( 0==c_nWidth, "width requires an integer" );
+				return std::forward<T>(t);
+			}
+		}
+
+		template<typename Str, std::size_t I, typename Tuple>
+		constexpr decltype(auto) format_segment_range(Tuple&& tuple) noexcept {
+			constexpr format_segment seg=parsed_format<Str>::c_aseg[I];
+			if constexpr( seg.m_bArgument ) {
+				return format_detail::format_argument<seg.m_chType, seg.m_nWidth>(std::get<seg.m_nArgument>(std::forward<Tuple>(tuple)));
+			} else {
+				return tc::counted(Str::get()+seg.m_nBegin, seg.m_nEnd-seg.m_nBegin);
+			}
+		}
+
+		template<typename Str, typename Tuple, std::size_t... I>
+		constexpr auto format_impl(Tuple&& tuple, std::index_sequence<I...>) noexcept {
+			if constexpr( 0==sizeof...(I) ) {
+				return tc::empty_range();
+			} else {
+				return tc::concat(format_detail::format_segment_range<Str, I>(std::forward<Tuple>(tuple))...);
+			}
+		}
+
+		// Upper bound of the number of characters an argument of type T is formatted to.
+		template<char c_chType, std::size_t c_nWidth, typename T>
+		constexpr std::size_t max_argument_size() noexcept {
+			if constexpr( 'd'!=c_chType ) {
+				static_assert( tc::is_actual_integer<T>::value, "hex format requires an integer" );
+				return (sizeof(T)*CHAR_BIT+3)/4; // the padding width is at most the number of hex digits
+			} else if constexpr( tc::is_actual_integer<T>::value ) {
+				if constexpr( 0==c_nWidth ) {
+					return tc::max(tc::as_dec(std::numeric_limits<T>::lowest()).size(), tc::as_dec(std::numeric_limits<T>::max()).size());
+				} else {
+					return tc::as_padded_dec<c_nWidth>(std::numeric_limits<std::make_unsigned_t<T>>::max()).size();
+				}
+			} else {
+				static_assert( tc::is_char<T>::value, "the size of ranges is not known at compile time" );
+				return 1;
+			}
+		}
+
+		template<typename Str, typename Tuple, std::size_t I>
+		constexpr std::size_t max_segment_size() noexcept {
+			constexpr format_segment seg=parsed_format<Str>::c_aseg[I];
+			if constexpr( seg.m_bArgument ) {
+				return format_detail::max_argument_size<seg.m_chType, seg.m_nWidth, tc::decay_t<std::tuple_element_t<seg.m_nArgument, Tuple>>>();
+			} else {
+				return seg.m_nEnd-seg.m_nBegin;
+			}
+		}
+
+		template<typename Str, typename Tuple, std::size_t... I>
+		constexpr std::size_t max_size_impl(std::index_sequence<I...>) noexcept {
+			return (std::size_t(0) + ... + format_detail::max_segment_size<Str, Tuple, I>());
+		}
+	}
+
+	// Str is a class with a static constexpr member function get() returning the format string literal, see tc_format.
+	// Upper bound of tc::size(tc::format<Str>(args...)) for integer and character arguments, e.g., to size a stack buffer.
+	template<typename Str, typename... Args>
+	[[nodiscard]] constexpr std::size_t format_max_size() noexcept {
+		using parsed = format_detail::parsed_format<Str>;
+		static_assert( sizeof...(Args)==parsed::c_nArguments, "number of arguments does not match format string" );
+		return format_detail::max_size_impl<Str, std::tuple<Args...>>(std::make_index_sequence<parsed::c_nSegments>());
+	}
+
+	template<typename Str, typename... Args>
+	[[nodiscard]] constexpr auto format(Args&&... args) noexcept {
+		using parsed = format_detail::parsed_format<Str>;
+		static_assert( sizeof...(Args)==parsed::c_nArguments, "number of arguments does not match format string" );
+		return format_detail::format_impl<Str>(std::forward_as_tuple(std::forward<Args>(args)...), std::make_index_sequence<parsed::c_nSegments>());
+	}
+
+	namespace no_adl {
+		template<typename Str>
+		struct [[nodiscard]] formatter final {
+			template<typename... Args>
+			constexpr auto operator()(Args&&... args) const& noexcept {
+				return tc::format<Str>(std::forward<Args>(args)...);
+			}
+
+			// tc_format("{:x}").max_size<int>()==8
+			template<typename... Args>
+			static constexpr std::size_t max_size() noexcept {
+				return tc::format_max_size<Str, Args...>();
+			}
+		};
+	}
+
+	template<typename Str>
+	constexpr no_adl::formatter<Str> make_formatter(Str) noexcept {
+		return {};
+	}
+
+	#define tc_format_string(str) [] { \
+		struct format_string final { \
+			static constexpr decltype(auto) get() noexcept { return (str); } \
+		}; \
+		return format_string(); \
+	}()
+
+	#define tc_format(str) tc::make_formatter(tc_format_string(str))
+
 	//////////////////////////////////////////////////
 	// conversion from string to number
 
@@ -250,6 +502,87 @@ namespace tc {
 		return tc::as_blob(nSize);
 	}
 
+	namespace varint_detail {
+		// Signed integers are zigzag encoded, so that small negative numbers have short encodings, too.
+		template<typename T>
+		constexpr std::make_unsigned_t<T> to_unsigned(T const n) noexcept {
+			using unsigned_type = std::make_unsigned_t<T>;
+			if constexpr( std::is_signed<T>::value ) {
+				return static_cast<unsigned_type>(static_cast<unsigned_type>(n)<<1) ^ static_cast<unsigned_type>(n>>(sizeof(T)*CHAR_BIT-1));
+			} else {
+				return n;
+			}
+		}
+	}
+
+	namespace no_adl {
+		// LEB128: 7 bits per byte, least significant first, high bit set on all but the last byte
+		template<typename T>
+		struct [[nodiscard]] as_varint_impl final {
+			using value_type = unsigned char;
+
+			constexpr explicit as_varint_impl(T const n) noexcept
+				: m_n(varint_detail::to_unsigned(n))
+			{}
+
+			constexpr std::size_t size() const& noexcept {
+				std::size_t nBytes=1;
+				for( auto n=m_n>>7; 0!=n; n>>=7 ) ++nBytes;
+				return nBytes;
+			}
+
+			template<typename Sink>
+			auto operator()(Sink&& sink) const& MAYTHROW {
+				STATICASSERTSAME(tc::sink_value_t<Sink>, unsigned char, "as_varint should only be used on binary sinks.");
+				std::array<unsigned char, (sizeof(T)*CHAR_BIT+6)/7> ab;
+				std::size_t nBytes=0;
+				auto n=m_n;
+				for( ; 0x80<=n; n>>=7 ) {
+					ab[nBytes++]=static_cast<unsigned char>(n|0x80);
+				}
+				ab[nBytes++]=static_cast<unsigned char>(n);
+				return tc::for_each(tc::counted(tc::as_const(ab).data(), nBytes), std::forward<Sink>(sink)); // one chunk, THROW(tc::file_failure)
+			}
+
+		private:
+			std::make_unsigned_t<T> m_n;
+		};
+
+		template<typename Rng>
+		struct [[nodiscard]] varint_prefixed_impl {
+			using value_type=unsigned char;
+
+			template<typename Rhs>
+			varint_prefixed_impl(aggregate_tag_t, Rhs&& rhs) noexcept
+				: m_rng(aggregate_tag, std::forward<Rhs>(rhs))
+			{}
+
+			template<typename Sink>
+			void operator()(Sink&& sink) const& MAYTHROW {
+				STATICASSERTSAME(tc::sink_value_t<Sink>, unsigned char, "varint_prefixed should only be used on binary sinks.");
+				tc::for_each(tc::concat(as_varint_impl<std::size_t>(tc::size(*m_rng)), tc::range_as_blob(*m_rng)), std::forward<Sink>(sink)); // THROW(tc::file_failure)
+			}
+
+			std::size_t size() const& noexcept {
+				return as_varint_impl<std::size_t>(tc::size(*m_rng)).size()+tc::size(*m_rng)*sizeof(tc::range_value_t<Rng>);
+			}
+		private:
+			tc::reference_or_value<Rng> m_rng;
+		};
+	}
+
+	template<typename T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>* = nullptr>
+	constexpr auto as_varint(T const n) noexcept {
+		return no_adl::as_varint_impl<T>(n);
+	}
+
+	// Like tc::size_prefixed, but the number of elements is written as tc::as_varint, which takes a single byte for less than 128 elements.
+	template< typename Rng >
+	auto varint_prefixed(Rng&& rng) return_ctor_noexcept(
+		no_adl::varint_prefixed_impl<Rng>,
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+
 	namespace no_adl {
 		template<typename T>
 		struct [[nodiscard]] bool_prefixed_impl {
@@ -272,7 +605,7 @@ namespace tc {
 		};
 	}
 
-	template< typename T, std::enable_if_t<tc::is_instance<std::optional, T>::value>* = nullptr >
+	template< typename T, std::enable_if_t<tc::is_instance<std::optional, tc::remove_cvref_t<T>>::value>* = nullptr >
 	auto bool_prefixed(T&& t) return_ctor_noexcept(
 		no_adl::bool_prefixed_impl<T>,
 		(aggregate_tag, std::forward<T>(t))
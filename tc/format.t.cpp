@@ -0,0 +1,45 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "range.h"
+#include "container.h" // tc::vector
+#include "range.t.h"
+#include "format.h"
+
+namespace {
+	constexpr auto c_nSegments=tc::format_detail::parse_format("{} items at {:x}", nullptr);
+	static_assert(3==c_nSegments);
+	static_assert(2==tc::format_detail::parse_format("{{}}", nullptr)+tc::format_detail::parse_format("", nullptr));
+
+	constexpr auto c_fmt=tc_format("{} items at {:x}");
+	static_assert(11+10+8==c_fmt.max_size<std::int32_t, std::uint32_t>()); // "-2147483648 items at ffffffff"
+	static_assert(3+1+1+16==tc_format("{:03}{}|{:X}").max_size<std::uint8_t, char, std::uint64_t>());
+	static_assert(20==tc_format("{:05}").max_size<std::int64_t>()); // the width is a minimum
+	static_assert(5==tc_format("{:05}").max_size<std::uint8_t>());
+}
+
+UNITTESTDEF( format_string ) {
+	TEST_RANGE_EQUAL( "12 items at 1ab", tc::make_str(tc_format("{} items at {:x}")(12, 0x1ab)) );
+	TEST_RANGE_EQUAL( "-7|0042|00ff|FF", tc::make_str(tc_format("{}|{:04}|{:04x}|{:X}")(-7, 42, 255, 255)) );
+	TEST_RANGE_EQUAL( "{literal} text", tc::make_str(tc_format("{{literal}} text")()) );
+
+	std::string const str="abc";
+	auto const rng=tc_format("{}: {}{}")(str, 'x', 5);
+	TEST_EQUAL( 7u, tc::size_raw(rng) );
+	TEST_RANGE_EQUAL( "abc: x5", tc::make_str(rng) );
+
+	// streams into any sink without allocating
+	std::size_t n=0;
+	tc::for_each(tc_format("{:08X}")(0xbeef), [&](char) noexcept { ++n; });
+	TEST_EQUAL( 8u, n );
+
+	// the bound holds for extreme values
+	auto const rngExtreme=tc_format("{} items at {:x}")(std::numeric_limits<std::int32_t>::lowest(), std::numeric_limits<std::uint32_t>::max());
+	constexpr std::size_t nMaxSize=c_fmt.max_size<std::int32_t, std::uint32_t>();
+	TEST_EQUAL( nMaxSize, tc::size_raw(rngExtreme) );
+}
@@ -15,21 +15,68 @@
 #include "for_each.h"
 #include "accumulate.h"
 #include "const_forward.h"
+#include "container.h"
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <memory>
 
 namespace tc {
 	namespace no_adl {
+		// Indices into the inner ranges require them to be lvalues which outlive the index.
+		template<typename RngRng, typename Enable=void>
+		struct has_join_iterator final : std::false_type {};
+
+		template<typename RngRng>
+		struct has_join_iterator<RngRng, std::enable_if_t<tc::is_range_with_iterators<std::remove_reference_t<RngRng>>::value>> final : std::integral_constant<bool,
+			std::is_lvalue_reference<tc::range_reference_t<std::remove_reference_t<RngRng>>>::value &&
+			tc::is_range_with_iterators<std::remove_reference_t<tc::range_reference_t<std::remove_reference_t<RngRng>>>>::value
+		> {};
+
+		// Table built on first use, possibly by several threads reading the same range at once; all but one of them discard their table.
+		// Copies start without a table, because their inner ranges may differ.
+		template<typename T>
+		struct lazy_vector final {
+			lazy_vector() noexcept : m_pvec(nullptr) {}
+			lazy_vector(lazy_vector const&) noexcept : m_pvec(nullptr) {}
+			lazy_vector& operator=(lazy_vector const&) & noexcept {
+				delete m_pvec.exchange(nullptr);
+				return *this;
+			}
+			~lazy_vector() {
+				delete m_pvec.load(std::memory_order_relaxed);
+			}
+
+			template<typename Func>
+			tc::vector<T> const& get(Func func) const& noexcept {
+				auto pvec=m_pvec.load(std::memory_order_acquire);
+				if( !pvec ) {
+					auto pvecNew=std::make_unique<tc::vector<T>>(func());
+					if( m_pvec.compare_exchange_strong(pvec, pvecNew.get(), std::memory_order_acq_rel, std::memory_order_acquire) ) {
+						pvec=pvecNew.release();
+					} // else pvec is the table of another thread
+				}
+				return *pvec;
+			}
+
+		private:
+			std::atomic<tc::vector<T>*> mutable m_pvec;
+		};
+
+		template<bool HasIterator, typename RngRng>
+		struct join_adaptor_impl;
+
 		template<
 			typename RngRng
 		>
-		struct [[nodiscard]] join_adaptor {
-		private:
+		struct [[nodiscard]] join_adaptor_impl<false, RngRng> {
+		protected:
 			reference_or_value<RngRng> m_baserng;
 
 		public:
 			template<typename Rhs>
-			explicit join_adaptor(aggregate_tag_t, Rhs&& rhs) noexcept
+			explicit join_adaptor_impl(aggregate_tag_t, Rhs&& rhs) noexcept
 				: m_baserng( aggregate_tag, std::forward<Rhs>(rhs) )
 			{}
 
@@ -43,19 +90,229 @@ namespace tc {
 				// Use tc::mul and boost::multiprecision::number?
 				tc::size_raw(static_cast<SFINAE_TYPE(RngRng const&)>(*m_baserng)) * tc::constexpr_size<tc::range_value_t<SFINAE_TYPE(RngRng)>>::value
 			)
+
+			// Enumerates the outer range, but not the inner ones.
+			template<ENABLE_SFINAE, std::enable_if_t<
+				!tc::has_constexpr_size<tc::range_value_t<SFINAE_TYPE(RngRng)>>::value &&
+				tc::has_size_upper_bound<tc::range_value_t<SFINAE_TYPE(RngRng)>>::value
+			>* = nullptr>
+			std::size_t size_upper_bound() const& MAYTHROW {
+				std::size_t n=0;
+				tc::for_each(*m_baserng, [&](auto const& rng) MAYTHROW {
+					n+=tc::size_upper_bound(rng);
+				});
+				return n;
+			}
 		};
 
-		template<typename RngRng>
-		struct constexpr_size_base<join_adaptor<RngRng>, std::void_t<typename tc::constexpr_size<RngRng>::type, typename tc::constexpr_size<tc::range_value_t<RngRng>>::type>>
+		namespace join_adaptor_detail {
+			template<typename OuterIndex, typename InnerIndex>
+			struct join_index final {
+				OuterIndex m_idxOuter;
+				InnerIndex m_idxInner; // unspecified at the end
+			};
+		}
+
+		template<
+			typename RngRng
+		>
+		struct [[nodiscard]] join_adaptor_impl<true, RngRng> :
+			join_adaptor_impl<false, RngRng>,
+			tc::range_iterator_from_index<
+				join_adaptor_impl<true, RngRng>,
+				join_adaptor_detail::join_index<
+					tc::index_t<std::remove_reference_t<RngRng>>,
+					tc::index_t<std::remove_reference_t<tc::range_reference_t<std::remove_reference_t<RngRng>>>>
+				>
+			>
+		{
+		private:
+			using this_type = join_adaptor_impl;
+			using outer_range_type = std::remove_reference_t<RngRng>;
+			using inner_range_type = std::remove_reference_t<tc::range_reference_t<outer_range_type>>;
+
+			static constexpr bool c_bBidirectional=
+				tc::has_decrement_index<outer_range_type>::value && tc::has_end_index<outer_range_type>::value &&
+				tc::has_decrement_index<inner_range_type>::value && tc::has_end_index<inner_range_type>::value;
+
+			static constexpr bool c_bRandomAccess=
+				tc::has_distance_to_index<outer_range_type>::value && tc::has_advance_index<outer_range_type>::value && tc::has_end_index<outer_range_type>::value &&
+				tc::has_distance_to_index<inner_range_type>::value && tc::has_advance_index<inner_range_type>::value && tc::has_size<inner_range_type>::value;
+
+		public:
+			using index = typename this_type::index;
+			using difference_type = std::ptrdiff_t;
+
+			template<typename Rhs>
+			explicit join_adaptor_impl(aggregate_tag_t, Rhs&& rhs) noexcept
+				: join_adaptor_impl<false, RngRng>(aggregate_tag, std::forward<Rhs>(rhs))
+			{}
+
+		private:
+			// Number of elements in the inner ranges before each inner range, and in total.
+			// Built on first use by the random-access operations: the sizes of the inner ranges must not change afterwards.
+			lazy_vector<difference_type> m_vecnPrefixSize;
+
+			outer_range_type& outer() const& noexcept {
+				return this->m_baserng.best_access();
+			}
+
+			inner_range_type& inner(tc::index_t<outer_range_type> const& idxOuter) const& noexcept {
+				return tc::dereference_index(outer(), idxOuter);
+			}
+
+			// skip empty inner ranges, so idx is either at the end or at an element
+			void skip_empty(index& idx) const& noexcept {
+				for( ; !tc::at_end_index(outer(), idx.m_idxOuter); tc::increment_index(outer(), idx.m_idxOuter) ) {
+					idx.m_idxInner=tc::begin_index(inner(idx.m_idxOuter));
+					if( !tc::at_end_index(inner(idx.m_idxOuter), idx.m_idxInner) ) return;
+				}
+			}
+
+			STATIC_FINAL(begin_index)() const& noexcept -> index {
+				index idx{tc::begin_index(outer()), {}};
+				skip_empty(idx);
+				return idx;
+			}
+
+			STATIC_FINAL_MOD(
+				template<
+					ENABLE_SFINAE BOOST_PP_COMMA()
+					std::enable_if_t<tc::has_end_index<SFINAE_TYPE(outer_range_type)>::value>* = nullptr
+				>,
+				end_index
+			)() const& noexcept -> index {
+				return {tc::end_index(outer()), {}};
+			}
+
+			STATIC_FINAL(at_end_index)(index const& idx) const& noexcept -> bool {
+				return tc::at_end_index(outer(), idx.m_idxOuter);
+			}
+
+			STATIC_FINAL(dereference_index)(index const& idx) const& noexcept -> decltype(auto) {
+				_ASSERT(!this->at_end_index(idx));
+				return tc::dereference_index(inner(idx.m_idxOuter), idx.m_idxInner);
+			}
+
+			STATIC_FINAL_MOD(
+				template<
+					ENABLE_SFINAE BOOST_PP_COMMA()
+					std::enable_if_t<
+						tc::has_equal_index<SFINAE_TYPE(outer_range_type)>::value &&
+						tc::has_equal_index<SFINAE_TYPE(inner_range_type)>::value
+					>* = nullptr
+				>,
+				equal_index
+			)(index const& idxLhs, index const& idxRhs) const& noexcept -> bool {
+				return tc::equal_index(outer(), idxLhs.m_idxOuter, idxRhs.m_idxOuter) &&
+					(tc::at_end_index(outer(), idxLhs.m_idxOuter) || tc::equal_index(inner(idxLhs.m_idxOuter), idxLhs.m_idxInner, idxRhs.m_idxInner));
+			}
+
+			STATIC_FINAL(increment_index)(index& idx) const& noexcept -> void {
+				_ASSERT(!this->at_end_index(idx));
+				tc::increment_index(inner(idx.m_idxOuter), idx.m_idxInner);
+				if( tc::at_end_index(inner(idx.m_idxOuter), idx.m_idxInner) ) {
+					tc::increment_index(outer(), idx.m_idxOuter);
+					skip_empty(idx);
+				}
+			}
+
+			STATIC_FINAL_MOD(
+				template<
+					ENABLE_SFINAE BOOST_PP_COMMA()
+					std::enable_if_t<SFINAE_VALUE(c_bBidirectional)>* = nullptr
+				>,
+				decrement_index
+			)(index& idx) const& noexcept -> void {
+				if( this->at_end_index(idx) || tc::equal_index(inner(idx.m_idxOuter), tc::begin_index(inner(idx.m_idxOuter)), idx.m_idxInner) ) {
+					do {
+						tc::decrement_index(outer(), idx.m_idxOuter);
+						idx.m_idxInner=tc::end_index(inner(idx.m_idxOuter));
+					} while( tc::equal_index(inner(idx.m_idxOuter), tc::begin_index(inner(idx.m_idxOuter)), idx.m_idxInner) );
+				}
+				tc::decrement_index(inner(idx.m_idxOuter), idx.m_idxInner);
+			}
+
+			tc::vector<difference_type> const& prefix_sizes() const& noexcept {
+				return m_vecnPrefixSize.get([&]() noexcept {
+					tc::vector<difference_type> vecnPrefixSize;
+					tc::cont_reserve(vecnPrefixSize, tc::size_raw(outer())+1);
+					difference_type n=0;
+					tc::cont_emplace_back(vecnPrefixSize, n);
+					tc::for_each(outer(), [&](auto const& rngInner) noexcept {
+						n+=tc::explicit_cast<difference_type>(tc::size_raw(rngInner));
+						tc::cont_emplace_back(vecnPrefixSize, n);
+					});
+					return vecnPrefixSize;
+				});
+			}
+
+			difference_type position(index const& idx) const& noexcept {
+				auto const& vecnPrefixSize=prefix_sizes();
+				if( this->at_end_index(idx) ) return vecnPrefixSize.back();
+				return vecnPrefixSize[static_cast<std::size_t>(tc::distance_to_index(outer(), tc::begin_index(outer()), idx.m_idxOuter))] +
+					tc::explicit_cast<difference_type>(tc::distance_to_index(inner(idx.m_idxOuter), tc::begin_index(inner(idx.m_idxOuter)), idx.m_idxInner));
+			}
+
+			index index_at(difference_type const n) const& noexcept {
+				auto const& vecnPrefixSize=prefix_sizes();
+				_ASSERT(0<=n && n<=vecnPrefixSize.back());
+				if( vecnPrefixSize.back()==n ) return {tc::end_index(outer()), {}};
+				// last inner range starting at or before n, which is not empty
+				auto const itnPrefixSize=std::upper_bound(tc::begin(vecnPrefixSize), tc::end(vecnPrefixSize), n)-1;
+				index idx{tc::begin_index(outer()), {}};
+				tc::advance_index(outer(), idx.m_idxOuter, itnPrefixSize-tc::begin(vecnPrefixSize));
+				idx.m_idxInner=tc::begin_index(inner(idx.m_idxOuter));
+				tc::advance_index(inner(idx.m_idxOuter), idx.m_idxInner, n-*itnPrefixSize);
+				return idx;
+			}
+
+			STATIC_FINAL_MOD(
+				template<
+					ENABLE_SFINAE BOOST_PP_COMMA()
+					std::enable_if_t<SFINAE_VALUE(c_bRandomAccess)>* = nullptr
+				>,
+				advance_index
+			)(index& idx, difference_type d) const& noexcept -> void {
+				idx=index_at(position(idx)+d);
+			}
+
+			STATIC_FINAL_MOD(
+				template<
+					ENABLE_SFINAE BOOST_PP_COMMA()
+					std::enable_if_t<SFINAE_VALUE(c_bRandomAccess)>* = nullptr
+				>,
+				distance_to_index
+			)(index const& idxLhs, index const& idxRhs) const& noexcept -> difference_type {
+				return position(idxRhs)-position(idxLhs);
+			}
+
+			STATIC_FINAL_MOD(
+				template<
+					ENABLE_SFINAE BOOST_PP_COMMA()
+					std::enable_if_t<SFINAE_VALUE(c_bRandomAccess)>* = nullptr
+				>,
+				middle_point
+			)(index& idx, index const& idxEnd) const& noexcept -> void {
+				idx=index_at((position(idx)+position(idxEnd))/2);
+			}
+		};
+
+		template<bool HasIterator, typename RngRng>
+		struct constexpr_size_base<join_adaptor_impl<HasIterator, RngRng>, std::void_t<typename tc::constexpr_size<RngRng>::type, typename tc::constexpr_size<tc::range_value_t<RngRng>>::type>>
 			: std::integral_constant<std::size_t, tc::constexpr_size<RngRng>::value * tc::constexpr_size<tc::range_value_t<RngRng>>::value>
 		{};
 
 		template<typename JoinAdaptor, typename RngRng>
-		struct range_value<JoinAdaptor, join_adaptor<RngRng>, tc::void_t<tc::range_value_t<tc::range_value_t<RngRng>>>> final {
+		struct range_value<JoinAdaptor, join_adaptor_impl<false, RngRng>, tc::void_t<tc::range_value_t<tc::range_value_t<RngRng>>>> final {
 			using type = tc::range_value_t<tc::range_value_t<RngRng>>;
 		};
 	}
-	using no_adl::join_adaptor;
+
+	// Index-based if the outer range has iterators and yields lvalue inner ranges with iterators. Random-access if both are,
+	// e.g., for a vector of vectors, using a table of inner range sizes which is built on first use.
+	template<typename RngRng>
+	using join_adaptor = no_adl::join_adaptor_impl<no_adl::has_join_iterator<RngRng>::value, RngRng>;
 
 	template<typename RngRng>
 	auto join(RngRng&& rng) return_ctor_noexcept(
@@ -0,0 +1,65 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "range.t.h"
+#include "container.h" // tc::vector
+#include "transform_adaptor.h"
+
+#include "join_adaptor.h"
+
+#include <thread>
+
+UNITTESTDEF(join_index_test) {
+	tc::vector<tc::vector<int>> vecvecn{{}, {1, 2}, {}, {}, {3}, {4, 5, 6}, {}};
+	auto rng = tc::join(vecvecn);
+
+	TEST_RANGE_EQUAL(rng, MAKE_CONSTEXPR_ARRAY(1, 2, 3, 4, 5, 6));
+	TEST_RANGE_EQUAL(tc::reverse(rng), MAKE_CONSTEXPR_ARRAY(6, 5, 4, 3, 2, 1));
+
+	_ASSERTEQUAL(*tc::begin_next(rng, 3), 4);
+	_ASSERTEQUAL(*tc::end_prev(rng, 4), 3);
+
+	auto it = tc::begin_next(rng, 2);
+	_ASSERTEQUAL(*(it + 3), 6);
+	_ASSERTEQUAL(*(it - 2), 1);
+	_ASSERTEQUAL(tc::end(rng)-tc::begin(rng), 6);
+	_ASSERTEQUAL(tc::begin(rng)-it, -2);
+	_ASSERTEQUAL(it + 4, tc::end(rng));
+
+	_ASSERTEQUAL(*tc::lower_bound<tc::return_border>(rng, 4), 4);
+	_ASSERTEQUAL(tc::lower_bound<tc::return_border>(rng, 7), tc::end(rng));
+
+	*tc::begin(rng) = 0;
+	_ASSERTEQUAL(vecvecn[1][0], 0);
+}
+
+UNITTESTDEF(join_empty_test) {
+	tc::vector<tc::vector<int>> vecvecn{{}, {}};
+	auto rng = tc::join(vecvecn);
+	_ASSERTEQUAL(tc::begin(rng), tc::end(rng));
+	_ASSERTEQUAL(tc::end(rng)-tc::begin(rng), 0);
+}
+
+UNITTESTDEF(join_concurrent_first_use) {
+	tc::vector<tc::vector<int>> vecvecn{{1, 2}, {3}, {4, 5, 6}};
+	auto const rng = tc::join(vecvecn);
+	std::thread thread([&]() noexcept { _ASSERTEQUAL(*tc::begin_next(rng, 4), 5); }); // both threads build the prefix sizes
+	_ASSERTEQUAL(*tc::begin_next(rng, 3), 4);
+	thread.join();
+	auto const rngCopy = rng; // starts without prefix sizes
+	_ASSERTEQUAL(*tc::end_prev(rngCopy, 2), 5);
+}
+
+UNITTESTDEF(join_prvalue_inner_test) {
+	tc::vector<int> vecn{1, 0, 2};
+	auto rng = tc::join(tc::transform(vecn, [](int n) noexcept { return tc::vector<int>(n, n); }));
+	static_assert(!tc::is_range_with_iterators<decltype(rng)>::value); // inner ranges are returned by value, so rng is only a generator
+	TEST_RANGE_EQUAL(rng, MAKE_CONSTEXPR_ARRAY(1, 2, 2));
+}
+
+static_assert(tc::has_distance_to_index<decltype(tc::join(std::declval<tc::vector<tc::vector<int>>&>()))>::value);
@@ -0,0 +1,141 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "range_defines.h"
+#include "break_or_continue.h"
+#include "subrange.h"
+#include "container.h"
+#include "reference_or_value.h"
+#include "minmax.h"
+#include "file_failure.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+	#include <io.h>
+#else
+	#include <unistd.h>
+#endif
+
+namespace tc {
+	namespace lines_detail {
+		// Calls sink for each line in [pchLine, pchEnd) that is terminated by '\n', without the '\n'. There is no '\n' in [pchLine, pchSearch).
+		// Afterwards, pchLine points to the unterminated rest.
+		template<typename Sink>
+		tc::break_or_continue for_each_terminated_line(char const*& pchLine, char const* pchSearch, char const* const pchEnd, Sink const& sink) MAYTHROW {
+			while( pchSearch!=pchEnd ) {
+				// memchr is vectorized by the C library
+				auto const pchNewline=static_cast<char const*>(std::memchr(pchSearch, '\n', pchEnd-pchSearch));
+				if( !pchNewline ) break;
+				auto const pchBegin=pchLine;
+				pchLine=pchNewline+1;
+				pchSearch=pchLine;
+				RETURN_IF_BREAK(tc::continue_if_not_break(sink, tc::make_iterator_range(pchBegin, pchNewline)));
+			}
+			return tc::continue_;
+		}
+
+		inline std::size_t read(int const fd, char* const pch, std::size_t const n) THROW(tc::file_failure) {
+			for(;;) {
+#ifdef _WIN32
+				auto const nRead=::_read(fd, pch, static_cast<unsigned int>(tc::min(n, std::size_t(1)<<30)));
+#else
+				auto const nRead=::read(fd, pch, n);
+#endif
+				if( 0<=nRead ) return static_cast<std::size_t>(nRead);
+				if( EINTR!=errno ) throw tc::file_failure();
+			}
+		}
+	}
+
+	namespace no_adl {
+		// Lines of a contiguous char range, e.g., tc::mapped_file, as views into the range.
+		template<typename Rng>
+		struct [[nodiscard]] contiguous_lines final {
+			using value_type = tc::ptr_range<char const>;
+
+			template<typename Rhs>
+			explicit contiguous_lines(aggregate_tag_t, Rhs&& rhs) noexcept
+				: m_rng(aggregate_tag, std::forward<Rhs>(rhs))
+			{}
+
+			template<typename Sink>
+			tc::break_or_continue operator()(Sink sink) const& MAYTHROW {
+				char const* pchLine=tc::ptr_begin(*m_rng);
+				char const* const pchEnd=tc::ptr_end(*m_rng);
+				RETURN_IF_BREAK(lines_detail::for_each_terminated_line(pchLine, pchLine, pchEnd, sink));
+				if( pchLine!=pchEnd ) {
+					return tc::continue_if_not_break(sink, tc::make_iterator_range(pchLine, pchEnd));
+				} else {
+					return tc::continue_;
+				}
+			}
+
+		private:
+			tc::reference_or_value<Rng> m_rng;
+		};
+
+		// Lines read from a file descriptor in blocks. The views passed to the sink are only valid during the call.
+		// Only the unterminated end of a block is moved to the front of the buffer before reading the next block.
+		// The file descriptor is read when iterating, so the range can be iterated once.
+		struct [[nodiscard]] fd_lines final {
+			using value_type = tc::ptr_range<char const>;
+
+			explicit fd_lines(int const fd, std::size_t const nBlockSize) noexcept
+				: m_fd(fd)
+				, m_nBlockSize(nBlockSize)
+			{
+				_ASSERT( 0<nBlockSize );
+			}
+
+			template<typename Sink>
+			tc::break_or_continue operator()(Sink sink) const& MAYTHROW {
+				tc::vector<char> vecch(m_nBlockSize);
+				std::size_t nCarry=0;
+				for(;;) {
+					if( nCarry==tc::size(vecch) ) {
+						NOBADALLOC(vecch.resize(tc::size(vecch)*2)); // line longer than the buffer
+					}
+					std::size_t const nRead=lines_detail::read(m_fd, tc::ptr_begin(vecch)+nCarry, tc::size(vecch)-nCarry); // THROW(tc::file_failure)
+					if( 0==nRead ) break;
+					char const* pchLine=tc::ptr_begin(vecch);
+					char const* const pchEnd=pchLine+nCarry+nRead;
+					RETURN_IF_BREAK(lines_detail::for_each_terminated_line(pchLine, pchLine+nCarry, pchEnd, sink));
+					nCarry=pchEnd-pchLine;
+					std::memmove(tc::ptr_begin(vecch), pchLine, nCarry);
+				}
+				if( 0<nCarry ) {
+					char const* const pchBegin=tc::ptr_begin(vecch);
+					return tc::continue_if_not_break(sink, tc::make_iterator_range(pchBegin, pchBegin+nCarry));
+				} else {
+					return tc::continue_;
+				}
+			}
+
+		private:
+			int m_fd;
+			std::size_t m_nBlockSize;
+		};
+	}
+
+	template<typename Rng, std::enable_if_t<
+		tc::has_ptr_begin<Rng>::value &&
+		std::is_same<tc::range_value_t<Rng>, char>::value
+	>* = nullptr>
+	auto lines(Rng&& rng) return_ctor_noexcept(
+		no_adl::contiguous_lines<Rng>,
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+
+	inline auto lines(int const fd, std::size_t const nBlockSize=1024*1024) noexcept {
+		return no_adl::fd_lines(fd, nBlockSize);
+	}
+}
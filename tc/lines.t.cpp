@@ -0,0 +1,41 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "range.h"
+#include "container.h" // tc::vector
+#include "range.t.h"
+#include "lines.h"
+#include "for_each_xxx.h"
+
+UNITTESTDEF( lines_contiguous ) {
+	std::string const str="first\n\nthird line\nlast";
+	TEST_RANGE_EQUAL( tc::make_str(tc::join_separated(tc::lines(str), "|")), "first||third line|last" );
+	_ASSERT( tc::empty(tc::make_str(tc::join_separated(tc::lines(std::string("\n")), "|"))) );
+
+	int nLines=0;
+	VERIFYEQUAL( tc::for_each(tc::lines(str), [&](auto const&) noexcept { return tc::continue_if(2!=++nLines); }), tc::break_ );
+	TEST_EQUAL( nLines, 2 );
+}
+
+#ifndef _WIN32
+UNITTESTDEF( lines_fd_carry ) {
+	int afd[2];
+	VERIFY( 0==::pipe(afd) );
+	std::string const strLong(20, 'x');
+	std::string const str=tc::make_str("ab\n", strLong, "\ncd\nefg\nh");
+	VERIFYEQUAL( ::write(afd[1], str.data(), str.size()), static_cast<ssize_t>(str.size()) );
+	::close(afd[1]);
+	// lines span blocks and one line is longer than the block
+	std::string strLines;
+	tc::for_each(tc::lines(afd[0], 4), [&](auto const& rngch) noexcept { // the fd can be read only once, so iterate exactly once
+		tc::append(strLines, rngch, "|");
+	});
+	TEST_RANGE_EQUAL( strLines, tc::concat("ab|", strLong, "|cd|efg|h|") );
+	::close(afd[0]);
+}
+#endif
@@ -0,0 +1,151 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "range_defines.h"
+#include "noncopyable.h"
+#include "file_failure.h"
+
+#include <cstddef>
+#include <utility>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace tc {
+	enum class mapped_file_access {
+		normal,
+		sequential, // read-ahead aggressively, pages may be dropped after reading
+		random, // no read-ahead
+		willneed // start reading the whole file in the background
+	};
+
+	namespace mapped_file_detail {
+		inline void* map(char const* szPath, std::size_t& nSize, mapped_file_access access) THROW(tc::file_failure) {
+#ifdef _WIN32
+			HANDLE const hfile=::CreateFileA(szPath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, mapped_file_access::sequential==access ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, nullptr);
+			if( INVALID_HANDLE_VALUE==hfile ) throw tc::file_failure();
+			LARGE_INTEGER nFileSize;
+			if( !::GetFileSizeEx(hfile, &nFileSize) ) {
+				::CloseHandle(hfile);
+				throw tc::file_failure();
+			}
+			nSize=static_cast<std::size_t>(nFileSize.QuadPart);
+			if( 0==nSize ) { // cannot map empty files
+				::CloseHandle(hfile);
+				return nullptr;
+			}
+			HANDLE const hmapping=::CreateFileMappingA(hfile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			::CloseHandle(hfile); // the mapping keeps the file open
+			if( !hmapping ) throw tc::file_failure();
+			void* const pv=::MapViewOfFile(hmapping, FILE_MAP_READ, 0, 0, 0);
+			::CloseHandle(hmapping); // the view keeps the mapping alive
+			if( !pv ) throw tc::file_failure();
+			return pv;
+#else
+			int const fd=::open(szPath, O_RDONLY | O_CLOEXEC);
+			if( fd<0 ) throw tc::file_failure();
+			struct stat st;
+			if( 0!=::fstat(fd, &st) ) {
+				::close(fd);
+				throw tc::file_failure();
+			}
+			nSize=static_cast<std::size_t>(st.st_size);
+			if( 0==nSize ) { // mmap fails for empty files
+				::close(fd);
+				return nullptr;
+			}
+			void* const pv=::mmap(nullptr, nSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd); // the mapping keeps the file open
+			if( MAP_FAILED==pv ) throw tc::file_failure();
+			switch_no_default( access ) {
+				case mapped_file_access::normal: break;
+				case mapped_file_access::sequential: ::madvise(pv, nSize, MADV_SEQUENTIAL); break;
+				case mapped_file_access::random: ::madvise(pv, nSize, MADV_RANDOM); break;
+				case mapped_file_access::willneed: ::madvise(pv, nSize, MADV_WILLNEED); break;
+			}
+			return pv;
+#endif
+		}
+
+		inline void unmap(void* pv, std::size_t nSize) noexcept {
+			if( pv ) {
+#ifdef _WIN32
+				VERIFY( ::UnmapViewOfFile(pv) );
+#else
+				VERIFY( 0==::munmap(pv, nSize) );
+#endif
+			}
+		}
+	}
+
+	namespace no_adl {
+		// Read-only memory-mapped file as contiguous range of Char. The file may be larger than available memory; pages are loaded on access.
+		// Modifying the file while it is mapped results in undefined content of the range.
+		template<typename Char>
+		struct basic_mapped_file final : tc::noncopyable {
+			static_assert(1==sizeof(Char));
+
+			using value_type = Char;
+			using iterator = Char const*;
+			using const_iterator = Char const*;
+
+			explicit basic_mapped_file(char const* szPath, mapped_file_access access=mapped_file_access::sequential) THROW(tc::file_failure)
+				: m_nSize(0)
+				, m_pv(mapped_file_detail::map(szPath, m_nSize, access))
+			{}
+
+			basic_mapped_file(basic_mapped_file&& other) noexcept
+				: m_nSize(other.m_nSize)
+				, m_pv(std::exchange(other.m_pv, nullptr))
+			{
+				other.m_nSize=0;
+			}
+
+			basic_mapped_file& operator=(basic_mapped_file&& other) & noexcept {
+				std::swap(m_nSize, other.m_nSize);
+				std::swap(m_pv, other.m_pv);
+				return *this;
+			}
+
+			~basic_mapped_file() {
+				mapped_file_detail::unmap(m_pv, m_nSize);
+			}
+
+			Char const* data() const& noexcept {
+				return static_cast<Char const*>(m_pv);
+			}
+			Char const* begin() const& noexcept {
+				return data();
+			}
+			Char const* end() const& noexcept {
+				return data()+m_nSize;
+			}
+			std::size_t size() const& noexcept {
+				return m_nSize;
+			}
+
+		private:
+			std::size_t m_nSize;
+			void* m_pv;
+		};
+	}
+	using no_adl::basic_mapped_file;
+	using mapped_file = basic_mapped_file<char>;
+	using mapped_blob = basic_mapped_file<unsigned char>;
+}
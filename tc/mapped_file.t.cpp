@@ -0,0 +1,41 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "range.h"
+#include "container.h" // tc::vector
+#include "range.t.h"
+#include "mapped_file.h"
+
+#ifndef _WIN32
+#include <cstdlib>
+
+UNITTESTDEF( mapped_file_range ) {
+	char szPath[]="/tmp/tc_mapped_file_XXXXXX";
+	int const fd=::mkstemp(szPath);
+	_ASSERT( 0<=fd );
+	std::string const str="first line\nsecond line\n";
+	VERIFYEQUAL( ::write(fd, str.data(), str.size()), static_cast<ssize_t>(str.size()) );
+	::close(fd);
+
+	{
+		tc::mapped_file file(szPath);
+		TEST_EQUAL( tc::size_raw(file), str.size() );
+		TEST_RANGE_EQUAL( file, str );
+		_ASSERT( tc::find_first<tc::return_bool>(file, '\n') );
+		_ASSERT( tc::ptr_begin(file)==file.data() );
+
+		tc::mapped_file fileMoved=tc_move(file);
+		_ASSERT( tc::empty(file) );
+		TEST_RANGE_EQUAL( fileMoved, str );
+	}
+
+	::truncate(szPath, 0);
+	_ASSERT( tc::empty(tc::mapped_blob(szPath, tc::mapped_file_access::random)) );
+	::unlink(szPath);
+}
+#endif
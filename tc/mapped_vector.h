@@ -0,0 +1,197 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "range_defines.h"
+#include "noncopyable.h"
+#include "file_failure.h"
+#include "subrange.h"
+#include "for_each.h"
+#include "minmax.h"
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tc {
+	namespace mapped_vector_detail {
+		// Changes the mapping of fd from nBytesOld to nBytesNew bytes. The file must already have nBytesNew bytes.
+		inline void* remap(int const fd, void* const pvOld, std::size_t const nBytesOld, std::size_t const nBytesNew) THROW(tc::file_failure) {
+			void* pv;
+			if( 0==nBytesOld ) {
+				pv=::mmap(nullptr, nBytesNew, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			} else {
+#ifdef __linux__
+				pv=::mremap(pvOld, nBytesOld, nBytesNew, MREMAP_MAYMOVE);
+#else
+				pv=::mmap(nullptr, nBytesNew, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+				if( MAP_FAILED!=pv ) {
+					VERIFY( 0==::munmap(pvOld, nBytesOld) );
+				}
+#endif
+			}
+			if( MAP_FAILED==pv ) throw tc::file_failure();
+			return pv;
+		}
+	}
+
+	namespace no_adl {
+		template<typename T>
+		struct mapped_vector;
+
+		template<typename T>
+		struct [[nodiscard]] mapped_vector_appender /*final*/ {
+			using sink_value_type = T;
+
+			explicit mapped_vector_appender(mapped_vector<T>& vec) noexcept : m_pvec(std::addressof(vec)) {}
+
+			void operator()(T const& t) const& THROW(tc::file_failure) {
+				m_pvec->push_back(t);
+			}
+
+			template<typename Rng, std::enable_if_t<
+				tc::has_ptr_begin<Rng const&>::value &&
+				std::is_same<tc::range_value_t<Rng>, T>::value
+			>* = nullptr>
+			auto chunk(Rng const& rng) const& THROW(tc::file_failure) {
+				auto const pBegin=tc::ptr_begin(rng);
+				m_pvec->append_raw(pBegin, static_cast<std::size_t>(tc::ptr_end(rng)-pBegin));
+				return INTEGRAL_CONSTANT(tc::continue_)();
+			}
+
+		private:
+			mapped_vector<T>* m_pvec;
+		};
+
+		// Vector of trivially copyable elements stored in a file. Opening an existing file gives direct access to the elements written before.
+		// Capacity is backed by the file, which is truncated to the used size on destruction.
+		template<typename T>
+		struct mapped_vector final : tc::nonmovable {
+			static_assert(std::is_trivially_copyable<T>::value);
+
+			using value_type = T;
+			using size_type = std::size_t;
+			using iterator = T*;
+			using const_iterator = T const*;
+
+			explicit mapped_vector(char const* szPath) THROW(tc::file_failure)
+				: m_fd(::open(szPath, O_RDWR | O_CREAT | O_CLOEXEC, 0644))
+				, m_pt(nullptr)
+				, m_nSize(0)
+				, m_nCapacity(0)
+			{
+				if( m_fd<0 ) throw tc::file_failure();
+				try {
+					struct stat st;
+					if( 0!=::fstat(m_fd, &st) ) throw tc::file_failure();
+					_ASSERTEQUAL( static_cast<std::size_t>(st.st_size)%sizeof(T), 0u );
+					std::size_t const n=static_cast<std::size_t>(st.st_size)/sizeof(T);
+					if( 0<n ) {
+						m_pt=static_cast<T*>(mapped_vector_detail::remap(m_fd, nullptr, 0, n*sizeof(T)));
+						m_nSize=n;
+						m_nCapacity=n;
+					}
+				} catch(...) {
+					::close(m_fd);
+					throw;
+				}
+			}
+
+			~mapped_vector() {
+				if( m_pt ) {
+					VERIFY( 0==::munmap(m_pt, m_nCapacity*sizeof(T)) );
+				}
+				if( m_nSize<m_nCapacity ) {
+					VERIFY( 0==::ftruncate(m_fd, m_nSize*sizeof(T)) );
+				}
+				::close(m_fd);
+			}
+
+			T* data() & noexcept { return m_pt; }
+			T const* data() const& noexcept { return m_pt; }
+			T* begin() & noexcept { return m_pt; }
+			T const* begin() const& noexcept { return m_pt; }
+			T* end() & noexcept { return m_pt+m_nSize; }
+			T const* end() const& noexcept { return m_pt+m_nSize; }
+			std::size_t size() const& noexcept { return m_nSize; }
+			std::size_t capacity() const& noexcept { return m_nCapacity; }
+
+			T& operator[](std::size_t const i) & noexcept {
+				_ASSERTDEBUG( i<m_nSize );
+				return m_pt[i];
+			}
+			T const& operator[](std::size_t const i) const& noexcept {
+				_ASSERTDEBUG( i<m_nSize );
+				return m_pt[i];
+			}
+
+			void reserve(std::size_t const n) & THROW(tc::file_failure) {
+				if( m_nCapacity<n ) {
+					if( 0!=::ftruncate(m_fd, n*sizeof(T)) ) throw tc::file_failure();
+					try {
+						m_pt=static_cast<T*>(mapped_vector_detail::remap(m_fd, m_pt, m_nCapacity*sizeof(T), n*sizeof(T)));
+					} catch(...) {
+						VERIFY( 0==::ftruncate(m_fd, m_nCapacity*sizeof(T)) ); // shrinking does not fail
+						throw;
+					}
+					m_nCapacity=n;
+				}
+			}
+
+			void push_back(T const& t) & THROW(tc::file_failure) {
+				if( m_nSize==m_nCapacity ) grow(m_nSize+1);
+				m_pt[m_nSize]=t;
+				++m_nSize;
+			}
+
+			void append_raw(T const* const pt, std::size_t const n) & THROW(tc::file_failure) {
+				if( m_nCapacity-m_nSize<n ) grow(m_nSize+n);
+				std::memcpy(m_pt+m_nSize, pt, n*sizeof(T));
+				m_nSize+=n;
+			}
+
+			template<typename It>
+			void take_inplace(It&& it) & noexcept {
+				_ASSERT( m_pt<=it && it<=end() );
+				m_nSize=static_cast<std::size_t>(it-m_pt);
+			}
+
+			void clear() & noexcept {
+				m_nSize=0;
+			}
+
+			mapped_vector_appender<T> appender() & noexcept {
+				return mapped_vector_appender<T>(*this);
+			}
+
+			// Writes modified pages to the file.
+			void flush() & THROW(tc::file_failure) {
+				if( m_pt && 0!=::msync(m_pt, m_nSize*sizeof(T), MS_SYNC) ) throw tc::file_failure();
+			}
+
+		private:
+			void grow(std::size_t const n) & THROW(tc::file_failure) {
+				reserve(tc::max(n, m_nCapacity*8/5, 4096/sizeof(T))); // at least one page
+			}
+
+			int const m_fd;
+			T* m_pt;
+			std::size_t m_nSize;
+			std::size_t m_nCapacity;
+		};
+	}
+	using no_adl::mapped_vector;
+}
+#endif
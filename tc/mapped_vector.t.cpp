@@ -0,0 +1,44 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "range.h"
+#include "container.h" // tc::vector
+#include "range.t.h"
+#include "mapped_vector.h"
+#include "counting_range.h"
+
+#ifndef _WIN32
+#include <cstdlib>
+
+UNITTESTDEF( mapped_vector_append_reopen ) {
+	char szPath[]="/tmp/tc_mapped_vector_XXXXXX";
+	int const fd=::mkstemp(szPath);
+	_ASSERT( 0<=fd );
+	::close(fd);
+
+	tc::vector<int> const vecn=tc::make_vector(tc::iota(0, 10000));
+	{
+		tc::mapped_vector<int> vecnMapped(szPath);
+		_ASSERT( tc::empty(vecnMapped) );
+		tc::append(vecnMapped, vecn); // chunk, memcpy
+		tc::append(vecnMapped, tc::iota(10000, 10010)); // element by element
+		tc::cont_reserve(vecnMapped, 100000);
+		_ASSERT( 100000<=vecnMapped.capacity() );
+		TEST_EQUAL( tc::size_raw(vecnMapped), 10010u );
+	}
+	{
+		tc::mapped_vector<int> vecnMapped(szPath);
+		TEST_RANGE_EQUAL( vecnMapped, tc::iota(0, 10010) );
+		TEST_EQUAL( vecnMapped.capacity(), 10010u ); // file was truncated to the used size
+		vecnMapped.push_back(-1);
+		tc::take_first_inplace(vecnMapped, 5);
+	}
+	TEST_RANGE_EQUAL( tc::mapped_vector<int>(szPath), tc::iota(0, 5) );
+	::unlink(szPath);
+}
+#endif
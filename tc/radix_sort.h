@@ -0,0 +1,367 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "range_defines.h"
+#include "type_traits.h"
+#include "assign.h"
+#include "compare.h"
+#include "bit_cast.h"
+#include "container.h"
+#include "size.h"
+#include "invoke.h"
+#include "minmax.h"
+#include "append.h"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+namespace tc {
+	namespace no_adl {
+		// Order preserving map to unsigned integers: tc::less(lhs, rhs) if and only if apply(lhs)<apply(rhs)
+		template<typename T, typename Enable=void>
+		struct radix_key {
+			static constexpr bool value=false;
+		};
+
+		template<typename T>
+		struct radix_key<T, std::enable_if_t<std::is_integral<T>::value && !tc::is_bool<T>::value>> {
+			static constexpr bool value=true;
+			using type = std::make_unsigned_t<T>;
+
+			static constexpr type apply(T t) noexcept {
+				if constexpr( std::is_signed<T>::value ) {
+					return static_cast<type>(static_cast<type>(t) ^ (type(1)<<(sizeof(type)*CHAR_BIT-1)));
+				} else {
+					return t;
+				}
+			}
+		};
+
+		template<typename T>
+		struct radix_key<T, std::enable_if_t<std::is_enum<T>::value>> : radix_key<std::underlying_type_t<T>> {
+			static constexpr auto apply(T t) noexcept {
+				return radix_key<std::underlying_type_t<T>>::apply(static_cast<std::underlying_type_t<T>>(t));
+			}
+		};
+
+		template<typename T>
+		struct radix_key<T, std::enable_if_t<std::is_floating_point<T>::value && std::numeric_limits<T>::is_iec559 && (4==sizeof(T) || 8==sizeof(T))>> {
+			static constexpr bool value=true;
+			using type = std::conditional_t<4==sizeof(T), std::uint32_t, std::uint64_t>;
+
+			static type apply(T t) noexcept {
+				if( 0==t ) t=0; // -0.0 and 0.0 compare equal
+				auto const n=tc::bit_cast<type>(t);
+				// negative numbers: order of magnitudes is reversed
+				return (n>>(sizeof(type)*CHAR_BIT-1)) ? static_cast<type>(~n) : static_cast<type>(n | (type(1)<<(sizeof(type)*CHAR_BIT-1)));
+			}
+		};
+
+		// Strings of char are compared by std::char_traits<char>::lt, which compares as unsigned char.
+		template<typename T>
+		struct is_radix_byte_string : std::false_type {};
+
+		template<typename Alloc>
+		struct is_radix_byte_string<std::basic_string<char, std::char_traits<char>, Alloc>> : std::true_type {};
+
+		// Predicates that sort by the radix_key of their (projected) arguments
+		template<typename Pred>
+		struct radix_pred {
+			static constexpr bool value=false;
+		};
+
+		template<>
+		struct radix_pred<tc::fn_less> {
+			static constexpr bool value=true;
+			static constexpr bool c_bThreeWay=false;
+			static constexpr bool c_bDescending=false;
+			static constexpr bool c_bIdentity=true;
+			static constexpr bool c_bByteString=true;
+
+			template<typename T>
+			static constexpr T&& project(tc::fn_less const&, T&& t) noexcept {
+				return std::forward<T>(t);
+			}
+		};
+
+		template<>
+		struct radix_pred<tc::fn_greater> {
+			static constexpr bool value=true;
+			static constexpr bool c_bThreeWay=false;
+			static constexpr bool c_bDescending=true;
+			static constexpr bool c_bIdentity=true;
+			static constexpr bool c_bByteString=true;
+
+			template<typename T>
+			static constexpr T&& project(tc::fn_greater const&, T&& t) noexcept {
+				return std::forward<T>(t);
+			}
+		};
+
+		template<>
+		struct radix_pred<tc::fn_compare> {
+			static constexpr bool value=true;
+			static constexpr bool c_bThreeWay=true;
+			static constexpr bool c_bDescending=false;
+			static constexpr bool c_bIdentity=true;
+			static constexpr bool c_bByteString=false; // tc::compare on std::basic_string compares char by char with sign
+
+			template<typename T>
+			static constexpr T&& project(tc::fn_compare const&, T&& t) noexcept {
+				return std::forward<T>(t);
+			}
+		};
+
+		template<typename Func, typename Transform>
+		struct radix_pred<tc::no_adl::projected_impl<Func, Transform>> : radix_pred<tc::decay_t<Func>> {
+			static constexpr bool c_bIdentity=false;
+
+			// keys are only used within the full-expression, so projections may return temporaries
+			template<typename T>
+			static constexpr decltype(auto) project(tc::no_adl::projected_impl<Func, Transform> const& pred, T&& t) MAYTHROW {
+				return radix_pred<tc::decay_t<Func>>::project(pred.m_func, tc::invoke(pred.m_transform, std::forward<T>(t)));
+			}
+		};
+
+		template<typename Pred>
+		struct radix_pred<std::reference_wrapper<Pred>> : radix_pred<std::remove_const_t<Pred>> {
+			template<typename T>
+			static constexpr decltype(auto) project(std::reference_wrapper<Pred> const& pred, T&& t) MAYTHROW {
+				return radix_pred<std::remove_const_t<Pred>>::project(pred.get(), std::forward<T>(t));
+			}
+		};
+	}
+
+	namespace radix_sort_detail {
+		template<typename Pred, typename T>
+		using projected_t = decltype(no_adl::radix_pred<Pred>::project(std::declval<Pred const&>(), std::declval<T>()));
+
+		template<typename Pred, typename T, typename Enable=void>
+		struct is_radix_sortable_elem final : std::false_type {};
+
+		template<typename Pred, typename T>
+		struct is_radix_sortable_elem<Pred, T, std::enable_if_t<no_adl::radix_pred<Pred>::value>> final : std::integral_constant<bool,
+			no_adl::radix_key<tc::decay_t<projected_t<Pred, T>>>::value
+			|| (no_adl::radix_pred<Pred>::c_bByteString && no_adl::is_radix_byte_string<tc::decay_t<projected_t<Pred, T>>>::value && std::is_lvalue_reference<projected_t<Pred, T>>::value)
+		> {};
+
+		// below, std::sort is faster than counting passes over the keys
+		inline constexpr std::size_t c_nRadixSortMinSize=256;
+		inline constexpr std::size_t c_nMsdRadixSortMinSize=64;
+
+		// LSD radix sort of [pBegin, pEnd) by the unsigned integer fnkey(elem), using pBuffer of the same size as scratch space. Stable.
+		template<typename T, typename FnKey>
+		void lsd_radix_sort(T* const pBegin, T* const pEnd, T* const pBuffer, FnKey fnkey) noexcept {
+			using key_type = decltype(fnkey(*pBegin));
+			static_assert(std::is_unsigned<key_type>::value);
+			static_assert(8==CHAR_BIT);
+			auto const n=tc::explicit_cast<std::size_t>(pEnd-pBegin);
+			_ASSERT(0<n);
+
+			// histograms of all bytes in a single pass
+			std::array<std::array<std::size_t, 256>, sizeof(key_type)> aanCount{};
+			for( T const* p=pBegin; p!=pEnd; ++p ) {
+				auto const nKey=fnkey(*p);
+				for( std::size_t iByte=0; iByte<sizeof(key_type); ++iByte ) {
+					++aanCount[iByte][(nKey>>(iByte*8)) & 0xff];
+				}
+			}
+
+			T* pSrc=pBegin;
+			T* pDst=pBuffer;
+			for( std::size_t iByte=0; iByte<sizeof(key_type); ++iByte ) {
+				auto& anCount=aanCount[iByte];
+				if( n==anCount[(fnkey(*pSrc)>>(iByte*8)) & 0xff] ) continue; // all keys share this byte
+				std::size_t nOffset=0;
+				for( auto& nCount : anCount ) {
+					nOffset+=std::exchange(nCount, nOffset);
+				}
+				for( T* p=pSrc; p!=pSrc+n; ++p ) {
+					pDst[anCount[(fnkey(*p)>>(iByte*8)) & 0xff]++]=tc_move_always(*p);
+				}
+				std::swap(pSrc, pDst);
+			}
+			if( pSrc!=pBegin ) {
+				std::move(pSrc, pSrc+n, pBegin);
+			}
+		}
+
+		struct string_record final {
+			unsigned char const* m_pch;
+			std::size_t m_nSize;
+			std::size_t m_i; // position in the sorted range
+		};
+
+		inline bool less_suffix(string_record const& lhs, string_record const& rhs, std::size_t nDepth) noexcept {
+			auto const nSize=tc::min(lhs.m_nSize, rhs.m_nSize);
+			if( nDepth<nSize ) {
+				if( auto const nCompare=std::memcmp(lhs.m_pch+nDepth, rhs.m_pch+nDepth, nSize-nDepth) ) {
+					return nCompare<0;
+				}
+			}
+			return lhs.m_nSize<rhs.m_nSize;
+		}
+
+		// MSD radix sort of strings, all of which share the first nDepth characters. Stable.
+		inline void msd_radix_sort(string_record* pBegin, string_record* const pEnd, string_record* const pBuffer, std::size_t nDepth) noexcept {
+			for(;;) {
+				auto const n=tc::explicit_cast<std::size_t>(pEnd-pBegin);
+				if( n<c_nMsdRadixSortMinSize ) {
+					std::stable_sort(pBegin, pEnd, [&](string_record const& lhs, string_record const& rhs) noexcept {
+						return less_suffix(lhs, rhs, nDepth);
+					});
+					return;
+				}
+
+				// bucket 0 holds the strings ending at nDepth
+				auto const digit=[&](string_record const& rec) noexcept -> std::size_t {
+					return nDepth<rec.m_nSize ? 1+rec.m_pch[nDepth] : 0;
+				};
+				std::array<std::size_t, 257> anCount{};
+				for( auto p=pBegin; p!=pEnd; ++p ) {
+					++anCount[digit(*p)];
+				}
+				if( auto const nDigit=digit(*pBegin); n==anCount[nDigit] ) {
+					if( 0==nDigit ) return; // all strings are equal
+					++nDepth; // common prefix, avoid recursion
+					continue;
+				}
+
+				std::array<std::size_t, 258> anOffset;
+				anOffset[0]=0;
+				for( std::size_t i=0; i<257; ++i ) {
+					anOffset[i+1]=anOffset[i]+anCount[i];
+				}
+				auto anInsert=anOffset;
+				for( auto p=pBegin; p!=pEnd; ++p ) {
+					pBuffer[anInsert[digit(*p)]++]=*p;
+				}
+				std::copy(pBuffer, pBuffer+n, pBegin);
+
+				for( std::size_t i=1; i<257; ++i ) {
+					if( 1<anCount[i] ) {
+						msd_radix_sort(pBegin+anOffset[i], pBegin+anOffset[i+1], pBuffer+anOffset[i], nDepth+1);
+					}
+				}
+				return;
+			}
+		}
+
+		// Positions of the elements in sorted order. fnelem(i) returns the i-th element. Stable.
+		template<typename Pred, typename FnElem>
+		tc::vector<std::size_t> sorted_permutation(std::size_t n, Pred const& pred, FnElem fnelem) noexcept {
+			using radixpred = no_adl::radix_pred<Pred>;
+			using projected = tc::decay_t<projected_t<Pred, decltype(fnelem(std::size_t(0)))>>;
+			tc::vector<std::size_t> veci;
+			veci.reserve(n);
+			if constexpr( no_adl::radix_key<projected>::value ) {
+				using key_type = typename no_adl::radix_key<projected>::type;
+				tc::vector<std::pair<key_type, std::size_t>> vecpairkeyi;
+				vecpairkeyi.reserve(n);
+				for( std::size_t i=0; i<n; ++i ) {
+					auto const nKey=no_adl::radix_key<projected>::apply(radixpred::project(pred, fnelem(i)));
+					tc::cont_emplace_back(vecpairkeyi, radixpred::c_bDescending ? static_cast<key_type>(~nKey) : nKey, i);
+				}
+				tc::vector<std::pair<key_type, std::size_t>> vecpairkeyiBuffer(n);
+				lsd_radix_sort(vecpairkeyi.data(), vecpairkeyi.data()+n, vecpairkeyiBuffer.data(), [](auto const& pairkeyi) noexcept { return pairkeyi.first; });
+				for( auto const& pairkeyi : vecpairkeyi ) {
+					tc::cont_emplace_back(veci, pairkeyi.second);
+				}
+			} else {
+				static_assert(no_adl::is_radix_byte_string<projected>::value);
+				tc::vector<string_record> vecrec;
+				vecrec.reserve(n);
+				for( std::size_t i=0; i<n; ++i ) {
+					auto const& str=radixpred::project(pred, fnelem(i));
+					tc::cont_emplace_back(vecrec, string_record{reinterpret_cast<unsigned char const*>(str.data()), str.size(), i});
+				}
+				tc::vector<string_record> vecrecBuffer(n);
+				msd_radix_sort(vecrec.data(), vecrec.data()+n, vecrecBuffer.data(), 0);
+				if constexpr( radixpred::c_bDescending ) {
+					// stable descending order: reverse each run of equal strings back
+					std::reverse(tc::begin(vecrec), tc::end(vecrec));
+					for( auto it=tc::begin(vecrec); it!=tc::end(vecrec); ) {
+						auto const itEqualEnd=std::find_if(it, tc::end(vecrec), [&](string_record const& rec) noexcept {
+							return less_suffix(rec, *it, 0);
+						});
+						std::reverse(it, itEqualEnd);
+						it=itEqualEnd;
+					}
+				}
+				for( auto const& rec : vecrec ) {
+					tc::cont_emplace_back(veci, rec.m_i);
+				}
+			}
+			return veci;
+		}
+
+		// Moves the element at position veci[i] to position i
+		template<typename It>
+		void move_into_order(It const itBegin, tc::vector<std::size_t> const& veci) noexcept {
+			tc::vector<tc::decay_t<decltype(*itBegin)>> vecv;
+			vecv.reserve(veci.size());
+			for( auto const i : veci ) {
+				tc::cont_emplace_back(vecv, tc_move_always(itBegin[i]));
+			}
+			std::move(tc::begin(vecv), tc::end(vecv), itBegin);
+		}
+	}
+
+	template<typename Rng, typename Pred, typename Enable=void>
+	struct is_radix_sortable final : std::false_type {};
+
+	// other predicates do not have c_bThreeWay, which fails substitution
+	template<typename Rng, typename Pred>
+	struct is_radix_sortable<Rng, Pred, std::enable_if_t<tc::is_random_access_range<Rng>::value && !no_adl::radix_pred<tc::decay_t<Pred>>::c_bThreeWay>> final : std::integral_constant<bool,
+		radix_sort_detail::is_radix_sortable_elem<tc::decay_t<Pred>, tc::range_reference_t<Rng>>::value
+	> {};
+
+	// Sorts rng like std::sort(rng, pred), but in O(n) passes over radix keys.
+	// Supported are tc::fn_less and tc::fn_greater, optionally tc::projected, on integral, enum, floating point and std::string keys.
+	template<typename Rng, typename Pred>
+	void radix_sort_inplace(Rng& rng, Pred const& pred) noexcept {
+		static_assert(tc::is_radix_sortable<Rng, Pred>::value);
+		auto const n=tc::explicit_cast<std::size_t>(tc::size_raw(rng));
+		auto const itBegin=tc::begin(rng);
+		if( n<radix_sort_detail::c_nRadixSortMinSize ) {
+			std::sort(itBegin, tc::end(rng), pred);
+			return;
+		}
+
+		using value_type = tc::range_value_t<Rng>;
+		using radixpred = no_adl::radix_pred<tc::decay_t<Pred>>;
+		if constexpr( radixpred::c_bIdentity && no_adl::radix_key<value_type>::value && std::is_trivially_copyable<value_type>::value ) {
+			// sort the values themselves, no permutation needed
+			using key = no_adl::radix_key<value_type>;
+			auto const fnkey=[](value_type const& v) noexcept {
+				auto const nKey=key::apply(v);
+				return radixpred::c_bDescending ? static_cast<typename key::type>(~nKey) : nKey;
+			};
+			tc::vector<value_type> vecvBuffer(n);
+			if constexpr( tc::has_ptr_begin<Rng&>::value ) {
+				// passes alternate between rng and the buffer, at most one copy back
+				auto const pBegin=tc::ptr_begin(rng);
+				radix_sort_detail::lsd_radix_sort(pBegin, pBegin+n, vecvBuffer.data(), fnkey);
+			} else {
+				auto vecv=tc::make_vector(rng);
+				radix_sort_detail::lsd_radix_sort(vecv.data(), vecv.data()+n, vecvBuffer.data(), fnkey);
+				std::copy(tc::begin(vecv), tc::end(vecv), itBegin);
+			}
+		} else {
+			radix_sort_detail::move_into_order(itBegin, radix_sort_detail::sorted_permutation(n, pred, [&](std::size_t i) noexcept -> decltype(auto) {
+				return itBegin[i];
+			}));
+		}
+	}
+}
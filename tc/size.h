@@ -271,5 +271,18 @@ namespace tc {
 	)
 
 	TC_HAS_EXPR(size, (T), size_raw(std::declval<T>()))
+
+	// tc::size_upper_bound() is a hint for reserving memory before enumerating a range without tc::size(), e.g., a filter or a generator.
+	// Adaptors provide a size_upper_bound member function if they can bound their size without enumerating their elements.
+	template<typename Rng, std::enable_if_t<tc::has_size<Rng const&>::value || has_mem_fn_size_upper_bound<Rng>::value>* = nullptr>
+	[[nodiscard]] constexpr std::size_t size_upper_bound(Rng const& rng) MAYTHROW {
+		if constexpr( tc::has_size<Rng const&>::value ) {
+			return tc::explicit_cast<std::size_t>(tc::size_raw(rng));
+		} else {
+			return rng.size_upper_bound();
+		}
+	}
+
+	TC_HAS_EXPR(size_upper_bound, (T), size_upper_bound(std::declval<T>()))
 }
 
@@ -13,6 +13,28 @@
 #include "for_each.h"
 
 namespace tc {
+	namespace no_adl {
+		// Counts the elements passed to it. Parts with tc::size, e.g., format generators like tc::as_dec, are counted without enumerating them.
+		struct [[nodiscard]] counting_sink /*final*/ {
+			constexpr explicit counting_sink(std::size_t& n) noexcept: m_n(n) {}
+
+			template<typename T>
+			constexpr void operator()(T const&) const& noexcept {
+				++m_n;
+			}
+
+			template<typename Rng, std::enable_if_t<tc::has_size<Rng const&>::value>* = nullptr>
+			constexpr auto chunk(Rng const& rng) const& noexcept {
+				m_n+=tc::size_raw(rng);
+				return INTEGRAL_CONSTANT(tc::continue_)();
+			}
+
+		private:
+			std::size_t& m_n;
+		};
+	}
+	using no_adl::counting_sink;
+
 	template<typename Rng, std::enable_if_t<!tc::has_size<Rng const>::value && tc::is_range_with_iterators<Rng const>::value>* =nullptr>
 	[[nodiscard]] auto size_linear_raw(Rng const& rng) return_decltype_MAYTHROW(
 		boost::distance(rng)
@@ -21,7 +43,7 @@ namespace tc {
 	template<typename Rng, std::enable_if_t<!tc::has_size<Rng const>::value && !tc::is_range_with_iterators<Rng const>::value>* =nullptr>
 	[[nodiscard]] std::size_t size_linear_raw(Rng const& rng) noexcept {
 		std::size_t sz=0;
-		tc::for_each(rng, [&sz](auto&&...) noexcept {++sz;});
+		tc::for_each(rng, tc::counting_sink(sz));
 		return sz;
 	}
 
@@ -82,6 +82,10 @@ namespace tc {
 				}
 				return INTEGRAL_CONSTANT(tc::continue_)();
 			}
+
+			std::size_t size_upper_bound() const& noexcept {
+				return m_nEnd;
+			}
 		};
 
 		template<typename Rng>
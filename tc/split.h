@@ -0,0 +1,192 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "range_defines.h"
+#include "range_fwd.h"
+#include "range_adaptor.h"
+#include "static_polymorphism.h"
+#include "subrange.h"
+#include "for_each.h"
+#include "bitfield.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2<=_M_IX86_FP)
+	#define TC_SPLIT_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace tc {
+	namespace split_detail {
+		template<typename T>
+		struct single_delimiter final {
+			T m_t;
+
+			T const* find(T const* const pBegin, T const* const pEnd) const& noexcept {
+				if constexpr( 1==sizeof(T) && std::is_integral<T>::value ) {
+					if( pBegin==pEnd ) return pEnd;
+					auto const pFound=static_cast<T const*>(std::memchr(pBegin, static_cast<unsigned char>(m_t), pEnd-pBegin)); // vectorized by the C library
+					return pFound ? pFound : pEnd;
+				} else {
+					return std::find(pBegin, pEnd, m_t);
+				}
+			}
+		};
+
+		// Any of a set of byte-sized delimiters. Up to c_nMaxSse2 distinct delimiters are compared against 16 bytes
+		// at once, as in flat_hash_detail::group. Larger sets and the remaining bytes are looked up in a table.
+		template<typename T>
+		struct delimiter_set final {
+			static_assert(1==sizeof(T) && std::is_integral<T>::value);
+
+			template<typename Rng>
+			explicit delimiter_set(Rng const& rngt) noexcept
+				: m_ab() // all false
+				, m_at()
+				, m_nDelimiters(0)
+			{
+				tc::for_each(rngt, [&](T const t) noexcept {
+					auto& b=m_ab[static_cast<unsigned char>(t)];
+					if( !b ) {
+						b=true;
+						if( m_nDelimiters<c_nMaxSse2 ) m_at[m_nDelimiters]=t;
+						++m_nDelimiters;
+					}
+				});
+			}
+
+			T const* find(T const* pBegin, T const* const pEnd) const& noexcept {
+#ifdef TC_SPLIT_SSE2
+				if( 0<m_nDelimiters && m_nDelimiters<=c_nMaxSse2 ) {
+					__m128i avec[c_nMaxSse2];
+					for( int i=0; i<c_nMaxSse2; ++i ) {
+						avec[i]=_mm_set1_epi8(static_cast<char>(m_at[i<m_nDelimiters ? i : 0])); // unused slots repeat a delimiter
+					}
+					for( ; 16<=pEnd-pBegin; pBegin+=16 ) {
+						auto const vec=_mm_loadu_si128(reinterpret_cast<__m128i const*>(pBegin));
+						auto vecMatch=_mm_cmpeq_epi8(vec, avec[0]);
+						for( int i=1; i<c_nMaxSse2; ++i ) vecMatch=_mm_or_si128(vecMatch, _mm_cmpeq_epi8(vec, avec[i]));
+						if( auto const nMask=static_cast<unsigned long>(_mm_movemask_epi8(vecMatch)) ) {
+							return pBegin+tc::index_of_least_significant_bit(nMask);
+						}
+					}
+				}
+#endif
+				while( pBegin!=pEnd && !m_ab[static_cast<unsigned char>(*pBegin)] ) ++pBegin;
+				return pBegin;
+			}
+
+		private:
+			static constexpr int c_nMaxSse2=4;
+			std::array<bool, 256> m_ab;
+			std::array<T, c_nMaxSse2> m_at;
+			int m_nDelimiters;
+		};
+
+		template<typename T>
+		struct split_index final {
+			T const* m_pBegin;
+			T const* m_pEnd; // delimiter or end of range
+			bool m_bAtEnd;
+		};
+	}
+
+	namespace no_adl {
+		// Subranges of a contiguous range between delimiters. n delimiters yield n+1 subranges, which may be empty.
+		template<typename Rng, typename Delimiter>
+		struct [[nodiscard]] split_adaptor
+#ifndef TC_RANGE_ITERATOR_HELPER_BASE_CLASS_WORKAROUND
+			: range_iterator_generator_from_index<
+				split_adaptor<Rng, Delimiter>,
+				split_detail::split_index<std::remove_cv_t<std::remove_pointer_t<decltype(tc::ptr_begin(std::declval<Rng&>()))>>>
+			>
+#endif
+		{
+		private:
+			using this_type = split_adaptor;
+			using base_value_type = std::remove_cv_t<std::remove_pointer_t<decltype(tc::ptr_begin(std::declval<Rng&>()))>>;
+#ifdef TC_RANGE_ITERATOR_HELPER_BASE_CLASS_WORKAROUND
+			using Derived = this_type;
+#endif
+		public:
+#ifdef TC_RANGE_ITERATOR_HELPER_BASE_CLASS_WORKAROUND
+			using index = split_detail::split_index<base_value_type>;
+			DEFINE_RANGE_ITERATOR_GENERATOR_FROM_INDEX
+#else
+			using index = typename split_adaptor::index;
+#endif
+
+			template<typename RngRef, typename DelimiterRef>
+			explicit split_adaptor(RngRef&& rng, DelimiterRef&& delimiter) noexcept
+				: m_baserng(aggregate_tag, std::forward<RngRef>(rng))
+				, m_delimiter(std::forward<DelimiterRef>(delimiter))
+			{}
+
+		private:
+			reference_or_value<Rng> m_baserng;
+			Delimiter m_delimiter;
+
+			base_value_type const* ptr_end_base() const& noexcept {
+				return tc::ptr_end(*m_baserng);
+			}
+
+			index make_index(base_value_type const* const pBegin) const& noexcept {
+				return {pBegin, m_delimiter.find(pBegin, ptr_end_base()), false};
+			}
+
+			STATIC_FINAL(begin_index)() const& noexcept -> index {
+				return make_index(tc::ptr_begin(*m_baserng));
+			}
+
+			STATIC_FINAL(end_index)() const& noexcept -> index {
+				return {ptr_end_base(), ptr_end_base(), true};
+			}
+
+			STATIC_FINAL(at_end_index)(index const& idx) const& noexcept -> bool {
+				return idx.m_bAtEnd;
+			}
+
+			STATIC_FINAL(dereference_index)(index const& idx) const& noexcept {
+				_ASSERTE( !idx.m_bAtEnd );
+				return tc::make_iterator_range(idx.m_pBegin, idx.m_pEnd);
+			}
+
+			STATIC_FINAL(equal_index)(index const& idxLhs, index const& idxRhs) const& noexcept -> bool {
+				return idxLhs.m_bAtEnd==idxRhs.m_bAtEnd && idxLhs.m_pBegin==idxRhs.m_pBegin;
+			}
+
+			STATIC_FINAL(increment_index)(index& idx) const& noexcept -> void {
+				_ASSERTE( !idx.m_bAtEnd );
+				if( ptr_end_base()==idx.m_pEnd ) {
+					idx=this->end_index();
+				} else {
+					idx=make_index(idx.m_pEnd+1);
+				}
+			}
+		};
+	}
+	using no_adl::split_adaptor;
+
+	// tc::split(rng, t) splits at each t, tc::split(rng, rngt) splits at any element of rngt, e.g., tc::split(str, " \t").
+	template<typename Rng, typename Delimiter, std::enable_if_t<tc::has_ptr_begin<Rng>::value && !tc::is_range_with_iterators<Delimiter>::value>* = nullptr>
+	auto split(Rng&& rng, Delimiter const& delimiter) return_ctor_noexcept(
+		split_adaptor<Rng BOOST_PP_COMMA() split_detail::single_delimiter<tc::range_value_t<Rng>>>,
+		(std::forward<Rng>(rng), split_detail::single_delimiter<tc::range_value_t<Rng>>{delimiter})
+	)
+
+	template<typename Rng, typename RngDelimiter, std::enable_if_t<tc::has_ptr_begin<Rng>::value && tc::is_range_with_iterators<RngDelimiter>::value>* = nullptr>
+	auto split(Rng&& rng, RngDelimiter const& rngdelimiter) return_ctor_noexcept(
+		split_adaptor<Rng BOOST_PP_COMMA() split_detail::delimiter_set<tc::range_value_t<Rng>>>,
+		(std::forward<Rng>(rng), split_detail::delimiter_set<tc::range_value_t<Rng>>(rngdelimiter))
+	)
+}
@@ -0,0 +1,49 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2020 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "range.h"
+#include "container.h" // tc::vector
+#include "range.t.h"
+#include "split.h"
+#include "for_each_xxx.h"
+
+UNITTESTDEF( split_single_delimiter ) {
+	std::string const str="a,bc,,d,";
+	TEST_RANGE_EQUAL( tc::make_str(tc::join_separated(tc::split(str, ','), "|")), "a|bc||d|" );
+	TEST_EQUAL( tc::size_raw(tc::make_vector(tc::split(std::string(), ','))), 1u );
+
+	// index-based interface
+	auto const rngrng=tc::split(str, ',');
+	auto it=tc::begin(rngrng);
+	TEST_RANGE_EQUAL( *it, "a" );
+	++it;
+	TEST_RANGE_EQUAL( *it, "bc" );
+	_ASSERT( tc::begin(rngrng)!=it );
+	_ASSERT( tc::begin(rngrng)==tc::begin(rngrng) );
+
+	int nTokens=0;
+	tc::for_each(rngrng, [&](auto const& rngch) noexcept {
+		++nTokens;
+		return tc::continue_if(!tc::empty(rngch));
+	});
+	TEST_EQUAL( nTokens, 3 );
+}
+
+UNITTESTDEF( split_delimiter_set ) {
+	std::string const str="GET /index.html HTTP/1.1\r\nHost: x";
+	TEST_RANGE_EQUAL( "GET|/index.html|HTTP/1.1||Host:|x", tc::make_str(tc::join_separated(tc::split(str, " \r\n"), "|")) ); // one empty token between \r and \n
+}
+
+UNITTESTDEF( split_delimiter_set_long ) {
+	// long enough for the 16 byte blocks, with delimiters in the tail and a set too large for them
+	std::string const str="0123456789abcdef0123456789,abcdef\t0123456789abcdef01;2";
+	TEST_RANGE_EQUAL( "0123456789abcdef0123456789|abcdef|0123456789abcdef01|2", tc::make_str(tc::join_separated(tc::split(str, ",\t;"), "|")) );
+	TEST_RANGE_EQUAL( "0123456789abcdef0123456789|abcdef|0123456789abcdef01|2", tc::make_str(tc::join_separated(tc::split(str, ",\t;:|"), "|")) );
+	TEST_RANGE_EQUAL( str, tc::make_str(tc::join_separated(tc::split(str, "xyz"), "|")) );
+	TEST_RANGE_EQUAL( str, tc::make_str(tc::join_separated(tc::split(str, ""), "|")) );
+}
@@ -61,6 +61,11 @@ namespace tc {
 			constexpr auto size() const& noexcept {
 				return tc::size_raw(*this->m_baserng);
 			}
+
+			template< ENABLE_SFINAE, std::enable_if_t<!tc::has_size<SFINAE_TYPE(Rng)>::value && tc::has_size_upper_bound<SFINAE_TYPE(Rng)>::value>* = nullptr >
+			constexpr std::size_t size_upper_bound() const& MAYTHROW {
+				return tc::size_upper_bound(*this->m_baserng);
+			}
 		};
 
 		template< typename Func, typename Rng >